@@ -0,0 +1,527 @@
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Size in bytes of every node, picked as a small multiple of a 64-byte cache line
+#ifndef BPT_NODE_BYTES
+#define BPT_NODE_BYTES 256
+#endif
+
+#define BPT_CACHE_LINE 64
+
+// Number of keys that fit in a leaf (header + prev/next links + keys)
+#define BPT_LEAF_KEYS ((BPT_NODE_BYTES - 2 * (int)sizeof(int) - 2 * (int)sizeof(void*)) / (int)sizeof(int))
+
+// Number of separator keys that fit in an internal node (header + keys + one more child than keys)
+#define BPT_INTERNAL_KEYS ((BPT_NODE_BYTES - 2 * (int)sizeof(int) - (int)sizeof(void*)) / ((int)sizeof(int) + (int)sizeof(void*)))
+
+#define BPT_LEAF_MIN (BPT_LEAF_KEYS / 2)
+#define BPT_INTERNAL_MIN (BPT_INTERNAL_KEYS / 2)
+
+// Common header shared by leaf and internal nodes
+struct BPTNode {
+    int count;
+    int is_leaf;
+};
+
+// Leaf node: sorted keys, linked to its neighbours for in-order scans
+struct BPTLeaf {
+    struct BPTNode hdr;
+    int keys[BPT_LEAF_KEYS];
+    struct BPTLeaf* prev;
+    struct BPTLeaf* next;
+};
+
+// Internal node: keys[i] is the smallest key reachable through children[i + 1]
+struct BPTInternal {
+    struct BPTNode hdr;
+    int keys[BPT_INTERNAL_KEYS];
+    struct BPTNode* children[BPT_INTERNAL_KEYS + 1];
+};
+
+// Structure representing the whole B+-tree
+struct BPlusTree {
+    struct BPTNode* root;
+    struct BPTLeaf* first;
+    struct BPTLeaf* last;
+    size_t size;
+    int height;
+};
+
+// Cursor pointing at one key of a leaf; leaf == NULL means past the end
+struct BPTCursor {
+    struct BPTLeaf* leaf;
+    int pos;
+};
+
+// Function to allocate a zeroed node aligned to a cache line
+void* bpt_alloc_node(size_t bytes) {
+    size_t rounded = (bytes + BPT_CACHE_LINE - 1) / BPT_CACHE_LINE * BPT_CACHE_LINE;
+    void* node = aligned_alloc(BPT_CACHE_LINE, rounded);
+    if (node == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(node, 0, rounded);
+    return node;
+}
+
+struct BPTLeaf* bpt_create_leaf(void) {
+    struct BPTLeaf* leaf = (struct BPTLeaf*)bpt_alloc_node(sizeof(struct BPTLeaf));
+    leaf->hdr.is_leaf = 1;
+    return leaf;
+}
+
+struct BPTInternal* bpt_create_internal(void) {
+    return (struct BPTInternal*)bpt_alloc_node(sizeof(struct BPTInternal));
+}
+
+// Function to create an empty B+-tree
+struct BPlusTree* bpt_create(void) {
+    struct BPlusTree* tree = (struct BPlusTree*)malloc(sizeof(struct BPlusTree));
+    tree->root = NULL;
+    tree->first = tree->last = NULL;
+    tree->size = 0;
+    tree->height = 0;
+    return tree;
+}
+
+// Branchless lower bound: index of the first key >= key
+static inline int bpt_lower_bound(const int* keys, int n, int key) {
+    if (n == 0) {
+        return 0;
+    }
+    const int* base = keys;
+    while (n > 1) {
+        int half = n / 2;
+        base = (base[half] < key) ? base + half : base;
+        n -= half;
+    }
+    return (int)(base - keys) + (*base < key);
+}
+
+// Branchless upper bound: index of the first key > key
+static inline int bpt_upper_bound(const int* keys, int n, int key) {
+    if (n == 0) {
+        return 0;
+    }
+    const int* base = keys;
+    while (n > 1) {
+        int half = n / 2;
+        base = (base[half] <= key) ? base + half : base;
+        n -= half;
+    }
+    return (int)(base - keys) + (*base <= key);
+}
+
+// Function to find the leaf that may contain a key
+struct BPTLeaf* bpt_find_leaf(struct BPlusTree* tree, int key) {
+    struct BPTNode* node = tree->root;
+    if (node == NULL) {
+        return NULL;
+    }
+    while (!node->is_leaf) {
+        struct BPTInternal* in = (struct BPTInternal*)node;
+        node = in->children[bpt_upper_bound(in->keys, in->hdr.count, key)];
+    }
+    return (struct BPTLeaf*)node;
+}
+
+// Function to search for a key
+bool bpt_search(struct BPlusTree* tree, int key) {
+    struct BPTLeaf* leaf = bpt_find_leaf(tree, key);
+    if (leaf == NULL) {
+        return false;
+    }
+    int pos = bpt_lower_bound(leaf->keys, leaf->hdr.count, key);
+    return pos < leaf->hdr.count && leaf->keys[pos] == key;
+}
+
+// Helper to insert into a leaf; returns the new right sibling if the leaf was split
+struct BPTNode* bpt_insert_leaf(struct BPlusTree* tree, struct BPTLeaf* leaf, int key, int* split_key, bool* inserted) {
+    int count = leaf->hdr.count;
+    int pos = bpt_lower_bound(leaf->keys, count, key);
+    if (pos < count && leaf->keys[pos] == key) {
+        return NULL;
+    }
+    *inserted = true;
+
+    if (count < BPT_LEAF_KEYS) {
+        memmove(&leaf->keys[pos + 1], &leaf->keys[pos], (count - pos) * sizeof(int));
+        leaf->keys[pos] = key;
+        leaf->hdr.count++;
+        return NULL;
+    }
+
+    // Leaf is full: move the upper half into a new right sibling
+    struct BPTLeaf* right = bpt_create_leaf();
+    int mid = (BPT_LEAF_KEYS + 1) / 2;
+    if (pos < mid) {
+        int moved = count - (mid - 1);
+        memcpy(right->keys, &leaf->keys[mid - 1], moved * sizeof(int));
+        right->hdr.count = moved;
+        leaf->hdr.count = mid - 1;
+        memmove(&leaf->keys[pos + 1], &leaf->keys[pos], (mid - 1 - pos) * sizeof(int));
+        leaf->keys[pos] = key;
+        leaf->hdr.count++;
+    } else {
+        int moved = count - mid;
+        memcpy(right->keys, &leaf->keys[mid], moved * sizeof(int));
+        right->hdr.count = moved;
+        leaf->hdr.count = mid;
+        int rpos = pos - mid;
+        memmove(&right->keys[rpos + 1], &right->keys[rpos], (moved - rpos) * sizeof(int));
+        right->keys[rpos] = key;
+        right->hdr.count++;
+    }
+
+    // Link the new leaf into the leaf chain
+    right->next = leaf->next;
+    right->prev = leaf;
+    if (leaf->next != NULL) {
+        leaf->next->prev = right;
+    } else {
+        tree->last = right;
+    }
+    leaf->next = right;
+
+    *split_key = right->keys[0];
+    return &right->hdr;
+}
+
+// Helper to insert below a node; returns the new right sibling if the node was split
+struct BPTNode* bpt_insert_rec(struct BPlusTree* tree, struct BPTNode* node, int key, int* split_key, bool* inserted) {
+    if (node->is_leaf) {
+        return bpt_insert_leaf(tree, (struct BPTLeaf*)node, key, split_key, inserted);
+    }
+
+    struct BPTInternal* in = (struct BPTInternal*)node;
+    int idx = bpt_upper_bound(in->keys, in->hdr.count, key);
+    int child_key;
+    struct BPTNode* sibling = bpt_insert_rec(tree, in->children[idx], key, &child_key, inserted);
+    if (sibling == NULL) {
+        return NULL;
+    }
+
+    int count = in->hdr.count;
+    if (count < BPT_INTERNAL_KEYS) {
+        memmove(&in->keys[idx + 1], &in->keys[idx], (count - idx) * sizeof(int));
+        memmove(&in->children[idx + 2], &in->children[idx + 1], (count - idx) * sizeof(struct BPTNode*));
+        in->keys[idx] = child_key;
+        in->children[idx + 1] = sibling;
+        in->hdr.count++;
+        return NULL;
+    }
+
+    // Node is full: lay out all keys and children, then split around the middle key
+    int keys[BPT_INTERNAL_KEYS + 1];
+    struct BPTNode* children[BPT_INTERNAL_KEYS + 2];
+    memcpy(keys, in->keys, idx * sizeof(int));
+    keys[idx] = child_key;
+    memcpy(&keys[idx + 1], &in->keys[idx], (count - idx) * sizeof(int));
+    memcpy(children, in->children, (idx + 1) * sizeof(struct BPTNode*));
+    children[idx + 1] = sibling;
+    memcpy(&children[idx + 2], &in->children[idx + 1], (count - idx) * sizeof(struct BPTNode*));
+
+    int mid = (BPT_INTERNAL_KEYS + 1) / 2;
+    struct BPTInternal* right = bpt_create_internal();
+    in->hdr.count = mid;
+    memcpy(in->keys, keys, mid * sizeof(int));
+    memcpy(in->children, children, (mid + 1) * sizeof(struct BPTNode*));
+    right->hdr.count = BPT_INTERNAL_KEYS - mid;
+    memcpy(right->keys, &keys[mid + 1], right->hdr.count * sizeof(int));
+    memcpy(right->children, &children[mid + 1], (right->hdr.count + 1) * sizeof(struct BPTNode*));
+
+    *split_key = keys[mid];
+    return &right->hdr;
+}
+
+// Function to insert a key; returns false if it was already present
+bool bpt_insert(struct BPlusTree* tree, int key) {
+    if (tree->root == NULL) {
+        struct BPTLeaf* leaf = bpt_create_leaf();
+        tree->root = &leaf->hdr;
+        tree->first = tree->last = leaf;
+        tree->height = 1;
+    }
+
+    bool inserted = false;
+    int split_key;
+    struct BPTNode* sibling = bpt_insert_rec(tree, tree->root, key, &split_key, &inserted);
+    if (sibling != NULL) {
+        // Root was split: grow the tree by one level
+        struct BPTInternal* root = bpt_create_internal();
+        root->hdr.count = 1;
+        root->keys[0] = split_key;
+        root->children[0] = tree->root;
+        root->children[1] = sibling;
+        tree->root = &root->hdr;
+        tree->height++;
+    }
+    if (inserted) {
+        tree->size++;
+    }
+    return inserted;
+}
+
+// Helper to fix an underfull leaf child by borrowing from or merging with a sibling
+void bpt_rebalance_leaf(struct BPlusTree* tree, struct BPTInternal* parent, int idx) {
+    struct BPTLeaf* child = (struct BPTLeaf*)parent->children[idx];
+    struct BPTLeaf* left = idx > 0 ? (struct BPTLeaf*)parent->children[idx - 1] : NULL;
+    struct BPTLeaf* right = idx < parent->hdr.count ? (struct BPTLeaf*)parent->children[idx + 1] : NULL;
+
+    if (left != NULL && left->hdr.count > BPT_LEAF_MIN) {
+        memmove(&child->keys[1], &child->keys[0], child->hdr.count * sizeof(int));
+        child->keys[0] = left->keys[--left->hdr.count];
+        child->hdr.count++;
+        parent->keys[idx - 1] = child->keys[0];
+        return;
+    }
+    if (right != NULL && right->hdr.count > BPT_LEAF_MIN) {
+        child->keys[child->hdr.count++] = right->keys[0];
+        memmove(&right->keys[0], &right->keys[1], (--right->hdr.count) * sizeof(int));
+        parent->keys[idx] = right->keys[0];
+        return;
+    }
+
+    // Merge the right one of the pair into the left one
+    int j = left != NULL ? idx - 1 : idx;
+    struct BPTLeaf* a = (struct BPTLeaf*)parent->children[j];
+    struct BPTLeaf* b = (struct BPTLeaf*)parent->children[j + 1];
+    memcpy(&a->keys[a->hdr.count], b->keys, b->hdr.count * sizeof(int));
+    a->hdr.count += b->hdr.count;
+    a->next = b->next;
+    if (b->next != NULL) {
+        b->next->prev = a;
+    } else {
+        tree->last = a;
+    }
+    free(b);
+
+    memmove(&parent->keys[j], &parent->keys[j + 1], (parent->hdr.count - j - 1) * sizeof(int));
+    memmove(&parent->children[j + 1], &parent->children[j + 2], (parent->hdr.count - j - 1) * sizeof(struct BPTNode*));
+    parent->hdr.count--;
+}
+
+// Helper to fix an underfull internal child by borrowing from or merging with a sibling
+void bpt_rebalance_internal(struct BPTInternal* parent, int idx) {
+    struct BPTInternal* child = (struct BPTInternal*)parent->children[idx];
+    struct BPTInternal* left = idx > 0 ? (struct BPTInternal*)parent->children[idx - 1] : NULL;
+    struct BPTInternal* right = idx < parent->hdr.count ? (struct BPTInternal*)parent->children[idx + 1] : NULL;
+
+    if (left != NULL && left->hdr.count > BPT_INTERNAL_MIN) {
+        // Rotate the separator down into the child and the left sibling's last key up
+        memmove(&child->keys[1], &child->keys[0], child->hdr.count * sizeof(int));
+        memmove(&child->children[1], &child->children[0], (child->hdr.count + 1) * sizeof(struct BPTNode*));
+        child->keys[0] = parent->keys[idx - 1];
+        child->children[0] = left->children[left->hdr.count];
+        parent->keys[idx - 1] = left->keys[left->hdr.count - 1];
+        left->hdr.count--;
+        child->hdr.count++;
+        return;
+    }
+    if (right != NULL && right->hdr.count > BPT_INTERNAL_MIN) {
+        // Rotate the separator down into the child and the right sibling's first key up
+        child->keys[child->hdr.count] = parent->keys[idx];
+        child->children[child->hdr.count + 1] = right->children[0];
+        child->hdr.count++;
+        parent->keys[idx] = right->keys[0];
+        memmove(&right->keys[0], &right->keys[1], (right->hdr.count - 1) * sizeof(int));
+        memmove(&right->children[0], &right->children[1], right->hdr.count * sizeof(struct BPTNode*));
+        right->hdr.count--;
+        return;
+    }
+
+    // Merge the pair, pulling the separator down between them
+    int j = left != NULL ? idx - 1 : idx;
+    struct BPTInternal* a = (struct BPTInternal*)parent->children[j];
+    struct BPTInternal* b = (struct BPTInternal*)parent->children[j + 1];
+    a->keys[a->hdr.count] = parent->keys[j];
+    memcpy(&a->keys[a->hdr.count + 1], b->keys, b->hdr.count * sizeof(int));
+    memcpy(&a->children[a->hdr.count + 1], b->children, (b->hdr.count + 1) * sizeof(struct BPTNode*));
+    a->hdr.count += 1 + b->hdr.count;
+    free(b);
+
+    memmove(&parent->keys[j], &parent->keys[j + 1], (parent->hdr.count - j - 1) * sizeof(int));
+    memmove(&parent->children[j + 1], &parent->children[j + 2], (parent->hdr.count - j - 1) * sizeof(struct BPTNode*));
+    parent->hdr.count--;
+}
+
+// Helper to delete below a node; returns true if the key was found
+bool bpt_delete_rec(struct BPlusTree* tree, struct BPTNode* node, int key) {
+    if (node->is_leaf) {
+        struct BPTLeaf* leaf = (struct BPTLeaf*)node;
+        int pos = bpt_lower_bound(leaf->keys, leaf->hdr.count, key);
+        if (pos == leaf->hdr.count || leaf->keys[pos] != key) {
+            return false;
+        }
+        memmove(&leaf->keys[pos], &leaf->keys[pos + 1], (leaf->hdr.count - pos - 1) * sizeof(int));
+        leaf->hdr.count--;
+        return true;
+    }
+
+    struct BPTInternal* in = (struct BPTInternal*)node;
+    int idx = bpt_upper_bound(in->keys, in->hdr.count, key);
+    struct BPTNode* child = in->children[idx];
+    if (!bpt_delete_rec(tree, child, key)) {
+        return false;
+    }
+
+    if (child->is_leaf && child->count < BPT_LEAF_MIN) {
+        bpt_rebalance_leaf(tree, in, idx);
+    } else if (!child->is_leaf && child->count < BPT_INTERNAL_MIN) {
+        bpt_rebalance_internal(in, idx);
+    }
+    return true;
+}
+
+// Function to delete a key; returns false if it was not present
+bool bpt_delete(struct BPlusTree* tree, int key) {
+    if (tree->root == NULL || !bpt_delete_rec(tree, tree->root, key)) {
+        return false;
+    }
+    tree->size--;
+
+    struct BPTNode* root = tree->root;
+    if (root->is_leaf && root->count == 0) {
+        free(root);
+        tree->root = NULL;
+        tree->first = tree->last = NULL;
+        tree->height = 0;
+    } else if (!root->is_leaf && root->count == 0) {
+        // Root has a single child left: shrink the tree by one level
+        tree->root = ((struct BPTInternal*)root)->children[0];
+        free(root);
+        tree->height--;
+    }
+    return true;
+}
+
+// Function to find the minimum key; returns false if the tree is empty
+bool bpt_find_min(struct BPlusTree* tree, int* key) {
+    if (tree->first == NULL) {
+        return false;
+    }
+    *key = tree->first->keys[0];
+    return true;
+}
+
+// Function to find the maximum key; returns false if the tree is empty
+bool bpt_find_max(struct BPlusTree* tree, int* key) {
+    if (tree->last == NULL) {
+        return false;
+    }
+    *key = tree->last->keys[tree->last->hdr.count - 1];
+    return true;
+}
+
+// Function to get the number of keys in the tree
+size_t bpt_size(struct BPlusTree* tree) {
+    return tree->size;
+}
+
+// Function to position a cursor on the smallest key
+struct BPTCursor bpt_begin(struct BPlusTree* tree) {
+    struct BPTCursor cursor = { tree->first, 0 };
+    return cursor;
+}
+
+// Function to position a cursor on the largest key
+struct BPTCursor bpt_end(struct BPlusTree* tree) {
+    struct BPTCursor cursor = { tree->last, tree->last != NULL ? tree->last->hdr.count - 1 : 0 };
+    return cursor;
+}
+
+// Function to position a cursor on the first key >= key
+struct BPTCursor bpt_seek(struct BPlusTree* tree, int key) {
+    struct BPTCursor cursor = { bpt_find_leaf(tree, key), 0 };
+    if (cursor.leaf != NULL) {
+        cursor.pos = bpt_lower_bound(cursor.leaf->keys, cursor.leaf->hdr.count, key);
+        if (cursor.pos == cursor.leaf->hdr.count) {
+            cursor.leaf = cursor.leaf->next;
+            cursor.pos = 0;
+        }
+    }
+    return cursor;
+}
+
+// Function to check whether a cursor points at a key
+bool bpt_cursor_valid(const struct BPTCursor* cursor) {
+    return cursor->leaf != NULL;
+}
+
+// Function to read the key under a valid cursor
+int bpt_cursor_key(const struct BPTCursor* cursor) {
+    return cursor->leaf->keys[cursor->pos];
+}
+
+// Function to advance a cursor to the next larger key
+void bpt_next(struct BPTCursor* cursor) {
+    if (++cursor->pos == cursor->leaf->hdr.count) {
+        cursor->leaf = cursor->leaf->next;
+        cursor->pos = 0;
+    }
+}
+
+// Function to move a cursor to the next smaller key
+void bpt_prev(struct BPTCursor* cursor) {
+    if (--cursor->pos < 0) {
+        cursor->leaf = cursor->leaf->prev;
+        cursor->pos = cursor->leaf != NULL ? cursor->leaf->hdr.count - 1 : 0;
+    }
+}
+
+// Function to call cb on every key in [lo, hi] in order; stops early if cb returns non-zero
+size_t bpt_range_scan(struct BPlusTree* tree, int lo, int hi, int (*cb)(int key, void* ctx), void* ctx) {
+    size_t visited = 0;
+    struct BPTCursor cursor = bpt_seek(tree, lo);
+    while (cursor.leaf != NULL) {
+        struct BPTLeaf* leaf = cursor.leaf;
+        for (int i = cursor.pos; i < leaf->hdr.count; ++i) {
+            if (leaf->keys[i] > hi) {
+                return visited;
+            }
+            visited++;
+            if (cb(leaf->keys[i], ctx)) {
+                return visited;
+            }
+        }
+        cursor.leaf = leaf->next;
+        cursor.pos = 0;
+    }
+    return visited;
+}
+
+// Helper to free a subtree
+void bpt_free_node(struct BPTNode* node) {
+    if (!node->is_leaf) {
+        struct BPTInternal* in = (struct BPTInternal*)node;
+        for (int i = 0; i <= in->hdr.count; ++i) {
+            bpt_free_node(in->children[i]);
+        }
+    }
+    free(node);
+}
+
+// Function to remove every key, keeping the tree usable
+void bpt_clear(struct BPlusTree* tree) {
+    if (tree->root != NULL) {
+        bpt_free_node(tree->root);
+    }
+    tree->root = NULL;
+    tree->first = tree->last = NULL;
+    tree->size = 0;
+    tree->height = 0;
+}
+
+// Function to free the tree and all of its nodes
+void bpt_destroy(struct BPlusTree* tree) {
+    bpt_clear(tree);
+    free(tree);
+}
+
+#endif
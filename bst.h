@@ -1,9 +1,24 @@
+#ifndef BST_H
+#define BST_H
+
 #include <stdio.h>
 #include <stdlib.h>
 
+// Compile with -DBST_STATS to instrument search, insert and deleteNode.
+// Without it every BST_STAT hook expands to nothing and nodes carry no extra field.
+#ifdef BST_STATS
+#define BST_STAT(stmt) do { stmt; } while (0)
+#else
+#define BST_STAT(stmt) ((void)0)
+#endif
+
 // Structure for a node in the BST
 struct Node {
     int data;
+    int size; // Number of nodes in the subtree rooted here
+#ifdef BST_STATS
+    int height; // Height of the subtree rooted here
+#endif
     struct Node *left;
     struct Node *right;
 };
@@ -12,22 +27,115 @@ struct Node {
 struct Node* create_node(int data) {
     struct Node* newNode = (struct Node*)malloc(sizeof(struct Node));
     newNode->data = data;
+    newNode->size = 1;
+    BST_STAT(newNode->height = 1);
     newNode->left = newNode->right = NULL;
     return newNode;
 }
 
-// Function to insert a new node into the BST
-struct Node* insert(struct Node* root, int data) {
+// Function to get the subtree size stored in a node (0 for an empty subtree)
+int node_size(struct Node* root) {
+    return root == NULL ? 0 : root->size;
+}
+
+#ifdef BST_STATS
+// Number of depth histogram buckets; deeper searches land in the last one
+#define BST_STATS_MAX_DEPTH 64
+
+// Record the depth of one search in every 2^BST_STATS_SAMPLE_SHIFT
+#ifndef BST_STATS_SAMPLE_SHIFT
+#define BST_STATS_SAMPLE_SHIFT 4
+#endif
+
+// Counters collected while BST_STATS is enabled
+struct BSTStats {
+    unsigned long long searches, inserts, deletes;
+    unsigned long long search_visits, insert_visits, delete_visits;
+    unsigned long long search_comparisons, insert_comparisons, delete_comparisons;
+    unsigned long long depth_histogram[BST_STATS_MAX_DEPTH + 1];
+    unsigned long long alarms;
+    double alarm_factor;
+    void (*alarm)(int depth, int size, void* ctx);
+    void* alarm_ctx;
+};
+
+struct BSTStats bst_stats;
+
+// Function to copy the current counters
+void bst_stats_snapshot(struct BSTStats* out) {
+    *out = bst_stats;
+}
+
+// Function to zero the counters, keeping the alarm settings
+void bst_stats_reset(void) {
+    double factor = bst_stats.alarm_factor;
+    void (*alarm)(int, int, void*) = bst_stats.alarm;
+    void* ctx = bst_stats.alarm_ctx;
+
+    bst_stats = (struct BSTStats){ 0 };
+    bst_stats.alarm_factor = factor;
+    bst_stats.alarm = alarm;
+    bst_stats.alarm_ctx = ctx;
+}
+
+// Function to call alarm(depth, size, ctx) whenever a path is longer than factor * log2(size)
+void bst_stats_set_alarm(double factor, void (*alarm)(int depth, int size, void* ctx), void* ctx) {
+    bst_stats.alarm_factor = factor;
+    bst_stats.alarm = alarm;
+    bst_stats.alarm_ctx = ctx;
+}
+
+// Helper to compare a depth against the alarm threshold for a tree of the given size
+void bst_stats_check_depth(int depth, int size) {
+    if (bst_stats.alarm == NULL || size < 2) {
+        return;
+    }
+    int log2_size = 0;
+    while ((size >> (log2_size + 1)) > 0) {
+        log2_size++;
+    }
+    if (depth > bst_stats.alarm_factor * log2_size) {
+        bst_stats.alarms++;
+        bst_stats.alarm(depth, size, bst_stats.alarm_ctx);
+    }
+}
+
+// Helper to read the height stored in a node (0 for an empty subtree)
+int node_height(struct Node* root) {
+    return root == NULL ? 0 : root->height;
+}
+#endif
+
+// Function to recompute a node's subtree size (and height under BST_STATS) from its children
+void update_size(struct Node* root) {
+    root->size = 1 + node_size(root->left) + node_size(root->right);
+    BST_STAT(root->height = 1 + (node_height(root->left) > node_height(root->right)
+                                     ? node_height(root->left) : node_height(root->right)));
+}
+
+// Helper to insert a key below root
+struct Node* insert_node(struct Node* root, int data) {
     if (root == NULL) {
         return create_node(data);
     }
 
+    BST_STAT(bst_stats.insert_visits++);
+    BST_STAT(bst_stats.insert_comparisons += data < root->data ? 1 : 2);
     if (data < root->data) {
-        root->left = insert(root->left, data);
+        root->left = insert_node(root->left, data);
     } else if (data > root->data) {
-        root->right = insert(root->right, data);
+        root->right = insert_node(root->right, data);
     }
 
+    update_size(root);
+    return root;
+}
+
+// Function to insert a new node into the BST
+struct Node* insert(struct Node* root, int data) {
+    root = insert_node(root, data);
+    BST_STAT(bst_stats.inserts++);
+    BST_STAT(bst_stats_check_depth(root->height, root->size));
     return root;
 }
 
@@ -60,15 +168,28 @@ void postorder(struct Node* root) {
 
 // Function to search for a node with a given key
 struct Node* search(struct Node* root, int key) {
-    if (root == NULL || root->data == key) {
-        return root;
+#ifdef BST_STATS
+    int depth = 0;
+    int tree_size = node_size(root);
+#endif
+
+    while (root != NULL && root->data != key) {
+        BST_STAT(depth++);
+        root = key < root->data ? root->left : root->right;
     }
 
-    if (key < root->data) {
-        return search(root->left, key);
+#ifdef BST_STATS
+    if (root != NULL) {
+        depth++;
     }
-
-    return search(root->right, key);
+    bst_stats.search_visits += depth;
+    bst_stats.search_comparisons += 2 * depth - (root != NULL);
+    if ((bst_stats.searches++ & ((1ull << BST_STATS_SAMPLE_SHIFT) - 1)) == 0) {
+        bst_stats.depth_histogram[depth < BST_STATS_MAX_DEPTH ? depth : BST_STATS_MAX_DEPTH]++;
+    }
+    bst_stats_check_depth(depth, tree_size);
+#endif
+    return root;
 }
 
 // Function to find the node with the minimum value
@@ -87,16 +208,18 @@ struct Node* find_max(struct Node* root) {
     return root;
 }
 
-// Function to delete a node with a given key from the BST
-struct Node* deleteNode(struct Node* root, int key) {
+// Helper to delete a key below root
+struct Node* delete_node(struct Node* root, int key) {
     if (root == NULL) {
         return root;
     }
 
+    BST_STAT(bst_stats.delete_visits++);
+    BST_STAT(bst_stats.delete_comparisons += key < root->data ? 1 : 2);
     if (key < root->data) {
-        root->left = deleteNode(root->left, key);
+        root->left = delete_node(root->left, key);
     } else if (key > root->data) {
-        root->right = deleteNode(root->right, key);
+        root->right = delete_node(root->right, key);
     } else {
         if (root->left == NULL) {
             struct Node* temp = root->right;
@@ -115,13 +238,23 @@ struct Node* deleteNode(struct Node* root, int key) {
         root->data = temp->data;
 
         // Delete the inorder successor
-        root->right = deleteNode(root->right, temp->data);
+        root->right = delete_node(root->right, temp->data);
     }
+    update_size(root);
     return root;
 }
 
-// Function to calculate the height of the tree
+// Function to delete a node with a given key from the BST
+struct Node* deleteNode(struct Node* root, int key) {
+    BST_STAT(bst_stats.deletes++);
+    return delete_node(root, key);
+}
+
+// Function to calculate the height of the tree (O(1) under BST_STATS, a full walk otherwise)
 int height(struct Node* root) {
+#ifdef BST_STATS
+    return node_height(root);
+#else
     if (root == NULL) {
         return 0;
     }
@@ -130,15 +263,68 @@ int height(struct Node* root) {
     int right_height = height(root->right);
 
     return 1 + (left_height > right_height ? left_height : right_height);
+#endif
 }
 
-// Function to calculate the size (number of nodes) of the tree
+// Function to get the size (number of nodes) of the tree in O(1)
 int size(struct Node* root) {
-    if (root == NULL) {
-        return 0;
+    return node_size(root);
+}
+
+// Function to find the node holding the k-th smallest key (0-based), or NULL if k is out of range
+struct Node* select_kth(struct Node* root, int k) {
+    if (k < 0 || k >= node_size(root)) {
+        return NULL;
     }
 
-    return 1 + size(root->left) + size(root->right);
+    while (root != NULL) {
+        int left_size = node_size(root->left);
+        if (k < left_size) {
+            root = root->left;
+        } else if (k > left_size) {
+            k -= left_size + 1;
+            root = root->right;
+        } else {
+            break;
+        }
+    }
+    return root;
+}
+
+// Function to count the keys strictly smaller than key
+int rank(struct Node* root, int key) {
+    int count = 0;
+    while (root != NULL) {
+        if (key <= root->data) {
+            root = root->left;
+        } else {
+            count += node_size(root->left) + 1;
+            root = root->right;
+        }
+    }
+    return count;
+}
+
+// Helper to count the keys smaller than or equal to key
+int rank_inclusive(struct Node* root, int key) {
+    int count = 0;
+    while (root != NULL) {
+        if (key < root->data) {
+            root = root->left;
+        } else {
+            count += node_size(root->left) + 1;
+            root = root->right;
+        }
+    }
+    return count;
+}
+
+// Function to count the keys in the closed range [lo, hi]
+int count_range(struct Node* root, int lo, int hi) {
+    if (lo > hi) {
+        return 0;
+    }
+    return rank_inclusive(root, hi) - rank(root, lo);
 }
 
 void display_leaf_nonleaf_count(struct Node *root, int *leafCount, int *nonLeafCount) {
@@ -164,14 +350,14 @@ void level_order_traversal(struct Node *root) {
         return;
     }
 
-    // Create a queue for level order traversal
-    struct Node *queue[100];
+    // Create a queue for level order traversal, sized to hold every node
+    struct Node **queue = (struct Node **)malloc(size(root) * sizeof(struct Node *));
     int front = -1, rear = -1;
 
     // Enqueue the root
     queue[++rear] = root;
 
-    while (front <= rear) {
+    while (front < rear) {
         // Dequeue a node
         struct Node *current = queue[++front];
 
@@ -188,6 +374,8 @@ void level_order_traversal(struct Node *root) {
             queue[++rear] = current->right;
         }
     }
+
+    free(queue);
 }
 
 // Function to visualize the BST (ASCII-based)
@@ -227,3 +415,343 @@ struct Node* clear(struct Node* root) {
     }
     return NULL;
 }
+
+// Maximum number of path entries an iterator keeps; a step that climbs past them re-descends
+// once from the root
+#define BST_ITER_DEPTH 64
+
+// Cursor over the keys of a tree in sorted order.
+// Holds the deepest part of the root-to-current path in a fixed ring buffer,
+// so stepping never recurses or allocates. Modifying the tree invalidates it.
+struct BSTIterator {
+    struct Node *root;
+    struct Node *path[BST_ITER_DEPTH];
+    int depth; // Length of the path; the current node is at depth - 1
+    int low;   // Shallowest path index still held in the ring buffer
+};
+
+// Helper to append a node to the iterator path
+void bst_iter_push(struct BSTIterator *it, struct Node *node) {
+    it->path[it->depth % BST_ITER_DEPTH] = node;
+    it->depth++;
+    if (it->depth - it->low > BST_ITER_DEPTH) {
+        it->low = it->depth - BST_ITER_DEPTH;
+    }
+}
+
+// Helper to get the node at a given path index
+struct Node *bst_iter_at(struct BSTIterator *it, int index) {
+    return it->path[index % BST_ITER_DEPTH];
+}
+
+// Helper to rebuild the path from the root down to the node holding key
+void bst_iter_reload(struct BSTIterator *it, int key) {
+    struct Node *node = it->root;
+    it->depth = it->low = 0;
+    while (node != NULL) {
+        bst_iter_push(it, node);
+        if (key == node->data) {
+            break;
+        }
+        node = key < node->data ? node->left : node->right;
+    }
+}
+
+// Function to initialise an iterator positioned past the end
+void bst_iter_init(struct BSTIterator *it, struct Node *root) {
+    it->root = root;
+    it->depth = it->low = 0;
+}
+
+// Function to check whether an iterator points at a node
+int bst_iter_valid(struct BSTIterator *it) {
+    return it->depth > 0;
+}
+
+// Function to get the node under a valid iterator
+struct Node *bst_iter_node(struct BSTIterator *it) {
+    return bst_iter_at(it, it->depth - 1);
+}
+
+// Function to position an iterator on the smallest key
+void bst_iter_begin(struct BSTIterator *it) {
+    it->depth = it->low = 0;
+    for (struct Node *node = it->root; node != NULL; node = node->left) {
+        bst_iter_push(it, node);
+    }
+}
+
+// Function to position an iterator on the largest key
+void bst_iter_last(struct BSTIterator *it) {
+    it->depth = it->low = 0;
+    for (struct Node *node = it->root; node != NULL; node = node->right) {
+        bst_iter_push(it, node);
+    }
+}
+
+// Helper to position an iterator with one descent from the root on the first key >= key
+// (dir 0), the first key > key (dir 1) or the last key < key (dir -1)
+void bst_iter_descend(struct BSTIterator *it, int key, int dir) {
+    struct Node *candidate = NULL;
+    int candidate_depth = 0;
+
+    it->depth = it->low = 0;
+    for (struct Node *node = it->root; node != NULL;) {
+        bst_iter_push(it, node);
+        int match = dir < 0 ? node->data < key : dir > 0 ? node->data > key : node->data >= key;
+        if (match) {
+            candidate = node;
+            candidate_depth = it->depth;
+        }
+        if (dir == 0 && key == node->data) {
+            break;
+        }
+        node = match == (dir >= 0) ? node->left : node->right;
+    }
+
+    if (candidate == NULL) {
+        it->depth = it->low = 0;
+    } else if (candidate_depth - 1 < it->low) {
+        bst_iter_reload(it, candidate->data);
+    } else {
+        it->depth = candidate_depth;
+    }
+}
+
+// Function to position an iterator on the first key >= key (lower bound)
+void bst_iter_seek(struct BSTIterator *it, int key) {
+    bst_iter_descend(it, key, 0);
+}
+
+// Function to advance an iterator to the next larger key
+void bst_iter_next(struct BSTIterator *it) {
+    struct Node *node = bst_iter_node(it);
+    int key = node->data;
+
+    if (node->right != NULL) {
+        for (node = node->right; node != NULL; node = node->left) {
+            bst_iter_push(it, node);
+        }
+        return;
+    }
+
+    // Climb until we arrive from a left child; if the parent has left the ring buffer,
+    // find the successor with a single descent instead
+    while (it->depth > 0) {
+        struct Node *child = bst_iter_node(it);
+        if (it->depth >= 2 && it->depth - 2 < it->low) {
+            bst_iter_descend(it, key, 1);
+            return;
+        }
+        it->depth--;
+        if (it->depth > 0 && bst_iter_node(it)->left == child) {
+            return;
+        }
+    }
+}
+
+// Function to move an iterator to the next smaller key
+void bst_iter_prev(struct BSTIterator *it) {
+    struct Node *node = bst_iter_node(it);
+    int key = node->data;
+
+    if (node->left != NULL) {
+        for (node = node->left; node != NULL; node = node->right) {
+            bst_iter_push(it, node);
+        }
+        return;
+    }
+
+    // Climb until we arrive from a right child; if the parent has left the ring buffer,
+    // find the predecessor with a single descent instead
+    while (it->depth > 0) {
+        struct Node *child = bst_iter_node(it);
+        if (it->depth >= 2 && it->depth - 2 < it->low) {
+            bst_iter_descend(it, key, -1);
+            return;
+        }
+        it->depth--;
+        if (it->depth > 0 && bst_iter_node(it)->right == child) {
+            return;
+        }
+    }
+}
+
+// Function to call visit on every key in order; stops early if visit returns non-zero
+int bst_for_each(struct Node *root, int (*visit)(int key, void *ctx), void *ctx) {
+    struct BSTIterator it;
+    int visited = 0;
+
+    bst_iter_init(&it, root);
+    for (bst_iter_begin(&it); bst_iter_valid(&it); bst_iter_next(&it)) {
+        visited++;
+        if (visit(bst_iter_node(&it)->data, ctx)) {
+            break;
+        }
+    }
+    return visited;
+}
+
+// Function to call visit on every key in [lo, hi] in order; stops early if visit returns non-zero
+int range_scan(struct Node *root, int lo, int hi, int (*visit)(int key, void *ctx), void *ctx) {
+    struct BSTIterator it;
+    int visited = 0;
+
+    bst_iter_init(&it, root);
+    for (bst_iter_seek(&it, lo); bst_iter_valid(&it); bst_iter_next(&it)) {
+        int key = bst_iter_node(&it)->data;
+        if (key > hi) {
+            break;
+        }
+        visited++;
+        if (visit(key, ctx)) {
+            break;
+        }
+    }
+    return visited;
+}
+
+// Pending subtree for the level-order bulk build: keys[lo..hi] hang off *link
+struct BuildRange {
+    int lo, hi;
+    struct Node **link;
+};
+
+// Function to build a perfectly balanced tree from keys sorted in ascending order in O(n).
+// Adjacent duplicates are skipped; returns NULL for empty or unsorted input.
+// Nodes are created in level order so the upper levels end up close together in memory.
+struct Node *build_balanced(const int *keys, int n) {
+    int unique = n > 0 ? 1 : 0;
+    for (int i = 1; i < n; i++) {
+        if (keys[i] < keys[i - 1]) {
+            return NULL;
+        }
+        unique += keys[i] != keys[i - 1];
+    }
+    if (unique == 0) {
+        return NULL;
+    }
+
+    // Only copy the input when duplicates have to be dropped
+    int *deduped = NULL;
+    if (unique < n) {
+        deduped = (int *)malloc(unique * sizeof(int));
+        int j = 0;
+        deduped[j++] = keys[0];
+        for (int i = 1; i < n; i++) {
+            if (keys[i] != keys[i - 1]) {
+                deduped[j++] = keys[i];
+            }
+        }
+        keys = deduped;
+    }
+
+    struct Node *root = NULL;
+    struct BuildRange *queue = (struct BuildRange *)malloc(unique * sizeof(struct BuildRange));
+    int front = 0, rear = 0;
+    queue[rear++] = (struct BuildRange){ 0, unique - 1, &root };
+
+    while (front < rear) {
+        struct BuildRange range = queue[front++];
+        int mid = range.lo + (range.hi - range.lo) / 2;
+        struct Node *node = create_node(keys[mid]);
+        node->size = range.hi - range.lo + 1;
+#ifdef BST_STATS
+        // Splitting at the middle gives a subtree of height floor(log2(size)) + 1
+        node->height = 1;
+        while ((node->size >> node->height) > 0) {
+            node->height++;
+        }
+#endif
+        *range.link = node;
+
+        if (range.lo < mid) {
+            queue[rear++] = (struct BuildRange){ range.lo, mid - 1, &node->left };
+        }
+        if (mid < range.hi) {
+            queue[rear++] = (struct BuildRange){ mid + 1, range.hi, &node->right };
+        }
+    }
+
+    free(queue);
+    free(deduped);
+    return root;
+}
+
+// Function to build a balanced tree from a sorted stream; next returns 0 once the stream is exhausted
+struct Node *build_balanced_stream(int (*next)(void *ctx, int *key), void *ctx) {
+    int capacity = 1024, n = 0;
+    int *keys = (int *)malloc(capacity * sizeof(int));
+    int key;
+
+    while (next(ctx, &key)) {
+        if (n == capacity) {
+            capacity *= 2;
+            keys = (int *)realloc(keys, capacity * sizeof(int));
+        }
+        keys[n++] = key;
+    }
+
+    struct Node *root = build_balanced(keys, n);
+    free(keys);
+    return root;
+}
+
+// Helper for rebuild: one pass of left rotations down the right spine
+void compress_vine(struct Node *pseudo_root, int count) {
+    struct Node *scanner = pseudo_root;
+    for (int i = 0; i < count; i++) {
+        struct Node *child = scanner->right;
+        scanner->right = child->right;
+        scanner = scanner->right;
+        child->right = scanner->left;
+        scanner->left = child;
+        update_size(child);
+        update_size(scanner);
+    }
+}
+
+// Function to rebalance a tree in place in O(n) without allocating (Day-Stout-Warren)
+struct Node *rebuild(struct Node *root) {
+    struct Node pseudo_root = { .left = NULL, .right = root };
+    int n = 0;
+
+    // Flatten the tree into a right-leaning vine with right rotations
+    struct Node *tail = &pseudo_root;
+    struct Node *rest = root;
+    while (rest != NULL) {
+        if (rest->left == NULL) {
+            tail = rest;
+            rest = rest->right;
+            n++;
+        } else {
+            struct Node *temp = rest->left;
+            rest->left = temp->right;
+            temp->right = rest;
+            rest = temp;
+            tail->right = temp;
+        }
+    }
+
+    // Along the vine each node's subtree is everything after it
+    int remaining = n;
+    for (struct Node *node = pseudo_root.right; node != NULL; node = node->right) {
+        BST_STAT(node->height = remaining);
+        node->size = remaining--;
+    }
+
+    // Fold the vine back into a complete tree
+    int full = 1;
+    while (full <= n + 1) {
+        full *= 2;
+    }
+    full = full / 2 - 1;
+    compress_vine(&pseudo_root, n - full);
+    for (int m = full / 2; m > 0; m /= 2) {
+        compress_vine(&pseudo_root, m);
+    }
+
+    return pseudo_root.right;
+}
+
+#endif
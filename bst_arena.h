@@ -0,0 +1,294 @@
+#ifndef BST_ARENA_H
+#define BST_ARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+// Nodes per arena chunk (must be a power of two)
+#define ARENA_CHUNK_SHIFT 12
+#define ARENA_CHUNK_NODES (1u << ARENA_CHUNK_SHIFT)
+#define ARENA_CHUNK_MASK (ARENA_CHUNK_NODES - 1)
+
+// Index 0 is never handed out and plays the role of NULL
+#define ARENA_NIL 0u
+
+// Structure for a node in an arena-backed BST; links are 32-bit arena indices
+struct ArenaNode {
+    int data;
+    int size; // Number of nodes in the subtree rooted here
+    uint32_t left;
+    uint32_t right;
+};
+
+// Structure for a BST whose nodes live in chunks owned by the tree
+struct ArenaTree {
+    struct ArenaNode** chunks;
+    uint32_t chunk_count;
+    uint32_t chunk_capacity;
+    uint32_t next_unused; // First index never handed out since the last clear
+    uint32_t free_list;   // Recycled nodes, chained through their left link
+    uint32_t root;
+};
+
+// Function to create an empty arena tree
+struct ArenaTree* arena_tree_create(void) {
+    struct ArenaTree* tree = (struct ArenaTree*)malloc(sizeof(struct ArenaTree));
+    tree->chunks = NULL;
+    tree->chunk_count = tree->chunk_capacity = 0;
+    tree->next_unused = 1;
+    tree->free_list = ARENA_NIL;
+    tree->root = ARENA_NIL;
+    return tree;
+}
+
+// Function to get the node stored at an index
+struct ArenaNode* arena_node(struct ArenaTree* tree, uint32_t index) {
+    return &tree->chunks[index >> ARENA_CHUNK_SHIFT][index & ARENA_CHUNK_MASK];
+}
+
+// Function to get the subtree size stored at an index (0 for ARENA_NIL)
+int arena_node_size(struct ArenaTree* tree, uint32_t index) {
+    return index == ARENA_NIL ? 0 : arena_node(tree, index)->size;
+}
+
+// Function to take a node from the free list, or from the end of the last chunk
+uint32_t arena_alloc_node(struct ArenaTree* tree, int data) {
+    uint32_t index = tree->free_list;
+
+    if (index != ARENA_NIL) {
+        tree->free_list = arena_node(tree, index)->left;
+    } else {
+        index = tree->next_unused;
+        if (index == UINT32_MAX) {
+            fprintf(stderr, "Arena index space exhausted\n");
+            exit(EXIT_FAILURE);
+        }
+        // Chunks survive arena_tree_clear, so only grow when past the last one
+        if ((index >> ARENA_CHUNK_SHIFT) >= tree->chunk_count) {
+            if (tree->chunk_count == tree->chunk_capacity) {
+                tree->chunk_capacity = tree->chunk_capacity ? tree->chunk_capacity * 2 : 4;
+                tree->chunks = (struct ArenaNode**)realloc(tree->chunks, tree->chunk_capacity * sizeof(struct ArenaNode*));
+            }
+            tree->chunks[tree->chunk_count++] = (struct ArenaNode*)malloc(ARENA_CHUNK_NODES * sizeof(struct ArenaNode));
+        }
+        tree->next_unused++;
+    }
+
+    struct ArenaNode* node = arena_node(tree, index);
+    node->data = data;
+    node->size = 1;
+    node->left = node->right = ARENA_NIL;
+    return index;
+}
+
+// Function to return a node to the free list
+void arena_free_node(struct ArenaTree* tree, uint32_t index) {
+    arena_node(tree, index)->left = tree->free_list;
+    tree->free_list = index;
+}
+
+// Function to search for a node with a given key
+struct ArenaNode* arena_search(struct ArenaTree* tree, int key) {
+    uint32_t index = tree->root;
+    while (index != ARENA_NIL) {
+        struct ArenaNode* node = arena_node(tree, index);
+        if (key == node->data) {
+            return node;
+        }
+        index = key < node->data ? node->left : node->right;
+    }
+    return NULL;
+}
+
+// Function to insert a key; returns 0 if it was already present
+int arena_insert(struct ArenaTree* tree, int key) {
+    if (arena_search(tree, key) != NULL) {
+        return 0;
+    }
+
+    // The key is new, so every node on the way down gains one descendant
+    uint32_t* link = &tree->root;
+    while (*link != ARENA_NIL) {
+        struct ArenaNode* node = arena_node(tree, *link);
+        node->size++;
+        link = key < node->data ? &node->left : &node->right;
+    }
+    // Allocate before writing through link: a new chunk never moves existing nodes
+    uint32_t index = arena_alloc_node(tree, key);
+    *link = index;
+    return 1;
+}
+
+// Function to delete a key; returns 0 if it was not present
+int arena_delete(struct ArenaTree* tree, int key) {
+    if (arena_search(tree, key) == NULL) {
+        return 0;
+    }
+
+    uint32_t* link = &tree->root;
+    struct ArenaNode* node = arena_node(tree, *link);
+    while (key != node->data) {
+        node->size--;
+        link = key < node->data ? &node->left : &node->right;
+        node = arena_node(tree, *link);
+    }
+
+    uint32_t index = *link;
+    if (node->left == ARENA_NIL || node->right == ARENA_NIL) {
+        *link = node->left != ARENA_NIL ? node->left : node->right;
+        arena_free_node(tree, index);
+        return 1;
+    }
+
+    // Node with two children: splice out the inorder successor and move its key up
+    node->size--;
+    uint32_t* succ_link = &node->right;
+    struct ArenaNode* succ = arena_node(tree, *succ_link);
+    while (succ->left != ARENA_NIL) {
+        succ->size--;
+        succ_link = &succ->left;
+        succ = arena_node(tree, *succ_link);
+    }
+    uint32_t succ_index = *succ_link;
+    node->data = succ->data;
+    *succ_link = succ->right;
+    arena_free_node(tree, succ_index);
+    return 1;
+}
+
+// Function to find the node with the minimum value, or NULL if the tree is empty
+struct ArenaNode* arena_find_min(struct ArenaTree* tree) {
+    if (tree->root == ARENA_NIL) {
+        return NULL;
+    }
+    struct ArenaNode* node = arena_node(tree, tree->root);
+    while (node->left != ARENA_NIL) {
+        node = arena_node(tree, node->left);
+    }
+    return node;
+}
+
+// Function to find the node with the maximum value, or NULL if the tree is empty
+struct ArenaNode* arena_find_max(struct ArenaTree* tree) {
+    if (tree->root == ARENA_NIL) {
+        return NULL;
+    }
+    struct ArenaNode* node = arena_node(tree, tree->root);
+    while (node->right != ARENA_NIL) {
+        node = arena_node(tree, node->right);
+    }
+    return node;
+}
+
+// Function to get the number of keys in the tree
+int arena_size(struct ArenaTree* tree) {
+    return arena_node_size(tree, tree->root);
+}
+
+// Function to find the node holding the k-th smallest key (0-based), or NULL if k is out of range
+struct ArenaNode* arena_select_kth(struct ArenaTree* tree, int k) {
+    if (k < 0 || k >= arena_size(tree)) {
+        return NULL;
+    }
+
+    struct ArenaNode* node = arena_node(tree, tree->root);
+    for (;;) {
+        int left_size = arena_node_size(tree, node->left);
+        if (k == left_size) {
+            return node;
+        }
+        if (k < left_size) {
+            node = arena_node(tree, node->left);
+        } else {
+            k -= left_size + 1;
+            node = arena_node(tree, node->right);
+        }
+    }
+}
+
+// Function to count the keys strictly smaller than key
+int arena_rank(struct ArenaTree* tree, int key) {
+    int count = 0;
+    uint32_t index = tree->root;
+    while (index != ARENA_NIL) {
+        struct ArenaNode* node = arena_node(tree, index);
+        if (key <= node->data) {
+            index = node->left;
+        } else {
+            count += arena_node_size(tree, node->left) + 1;
+            index = node->right;
+        }
+    }
+    return count;
+}
+
+// Function to drop every node in O(1); chunks are kept for reuse
+void arena_tree_clear(struct ArenaTree* tree) {
+    tree->next_unused = 1;
+    tree->free_list = ARENA_NIL;
+    tree->root = ARENA_NIL;
+}
+
+// Function to free the tree in O(number of chunks)
+void arena_tree_destroy(struct ArenaTree* tree) {
+    for (uint32_t i = 0; i < tree->chunk_count; i++) {
+        free(tree->chunks[i]);
+    }
+    free(tree->chunks);
+    free(tree);
+}
+
+// Pending subtree for the level-order bulk build: keys[lo..hi] hang off the node at parent
+struct ArenaBuildRange {
+    int lo, hi;
+    uint32_t parent;
+    int is_right;
+};
+
+// Function to replace the tree's contents with a balanced tree built from strictly increasing keys.
+// Nodes take consecutive indices in level order, so after a clear they fill chunks contiguously.
+// Returns 0 (leaving the tree untouched) if keys are not strictly increasing.
+int arena_build_balanced(struct ArenaTree* tree, const int* keys, int n) {
+    for (int i = 1; i < n; i++) {
+        if (keys[i] <= keys[i - 1]) {
+            return 0;
+        }
+    }
+
+    arena_tree_clear(tree);
+    if (n == 0) {
+        return 1;
+    }
+
+    struct ArenaBuildRange* queue = (struct ArenaBuildRange*)malloc(n * sizeof(struct ArenaBuildRange));
+    int front = 0, rear = 0;
+    queue[rear++] = (struct ArenaBuildRange){ 0, n - 1, ARENA_NIL, 0 };
+
+    while (front < rear) {
+        struct ArenaBuildRange range = queue[front++];
+        int mid = range.lo + (range.hi - range.lo) / 2;
+        uint32_t index = arena_alloc_node(tree, keys[mid]);
+        arena_node(tree, index)->size = range.hi - range.lo + 1;
+
+        if (range.parent == ARENA_NIL) {
+            tree->root = index;
+        } else if (range.is_right) {
+            arena_node(tree, range.parent)->right = index;
+        } else {
+            arena_node(tree, range.parent)->left = index;
+        }
+
+        if (range.lo < mid) {
+            queue[rear++] = (struct ArenaBuildRange){ range.lo, mid - 1, index, 0 };
+        }
+        if (mid < range.hi) {
+            queue[rear++] = (struct ArenaBuildRange){ mid + 1, range.hi, index, 1 };
+        }
+    }
+
+    free(queue);
+    return 1;
+}
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef BST_CONCURRENT_H
+#define BST_CONCURRENT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "epoch.h"
+
+// Ordered set of ints where readers never take a lock.
+// Every update becomes visible through a single atomic link store, and nodes
+// that readers may still be traversing are freed through epoch reclamation.
+// Writers are serialised by write_lock.
+
+// Structure for a node in the concurrent BST; data never changes once published
+struct CNode {
+    int data;
+    struct CNode* _Atomic left;
+    struct CNode* _Atomic right;
+};
+
+struct ConcurrentBST {
+    struct CNode* _Atomic root;
+    atomic_long count;
+    pthread_mutex_t write_lock;
+    struct EpochDomain epoch;
+};
+
+// Function to create a new node
+struct CNode* cbst_create_node(int data, struct CNode* left, struct CNode* right) {
+    struct CNode* node = (struct CNode*)malloc(sizeof(struct CNode));
+    node->data = data;
+    atomic_init(&node->left, left);
+    atomic_init(&node->right, right);
+    return node;
+}
+
+// Function to create an empty concurrent BST
+struct ConcurrentBST* cbst_create(void) {
+    struct ConcurrentBST* tree = (struct ConcurrentBST*)malloc(sizeof(struct ConcurrentBST));
+    atomic_init(&tree->root, NULL);
+    atomic_init(&tree->count, 0);
+    pthread_mutex_init(&tree->write_lock, NULL);
+    epoch_domain_init(&tree->epoch);
+    return tree;
+}
+
+// Function to register the calling thread as a reader; returns its reader id
+int cbst_register_reader(struct ConcurrentBST* tree) {
+    return epoch_register(&tree->epoch);
+}
+
+// Function to release a reader id
+void cbst_unregister_reader(struct ConcurrentBST* tree, int reader) {
+    epoch_unregister(&tree->epoch, reader);
+}
+
+// Helper to load a child link for reading
+struct CNode* cbst_load(struct CNode* _Atomic* link) {
+    return atomic_load_explicit(link, memory_order_acquire);
+}
+
+// Helper to publish a new value in a link
+void cbst_publish(struct CNode* _Atomic* link, struct CNode* node) {
+    atomic_store_explicit(link, node, memory_order_release);
+}
+
+// Function to search for a key without locking
+bool cbst_search(struct ConcurrentBST* tree, int reader, int key) {
+    epoch_enter(&tree->epoch, reader);
+    struct CNode* node = cbst_load(&tree->root);
+    while (node != NULL && node->data != key) {
+        node = cbst_load(key < node->data ? &node->left : &node->right);
+    }
+    epoch_exit(&tree->epoch, reader);
+    return node != NULL;
+}
+
+// Function to find the minimum key without locking; returns false if the tree is empty
+bool cbst_find_min(struct ConcurrentBST* tree, int reader, int* key) {
+    epoch_enter(&tree->epoch, reader);
+    struct CNode* node = cbst_load(&tree->root);
+    if (node != NULL) {
+        for (struct CNode* next; (next = cbst_load(&node->left)) != NULL;) {
+            node = next;
+        }
+        *key = node->data;
+    }
+    epoch_exit(&tree->epoch, reader);
+    return node != NULL;
+}
+
+// Function to find the maximum key without locking; returns false if the tree is empty
+bool cbst_find_max(struct ConcurrentBST* tree, int reader, int* key) {
+    epoch_enter(&tree->epoch, reader);
+    struct CNode* node = cbst_load(&tree->root);
+    if (node != NULL) {
+        for (struct CNode* next; (next = cbst_load(&node->right)) != NULL;) {
+            node = next;
+        }
+        *key = node->data;
+    }
+    epoch_exit(&tree->epoch, reader);
+    return node != NULL;
+}
+
+// Function to call visit on keys in [lo, hi] in order without locking; stops early if visit returns non-zero.
+// Keys present for the whole scan are reported exactly once; keys changed meanwhile at most once.
+long cbst_range_scan(struct ConcurrentBST* tree, int reader, int lo, int hi, int (*visit)(int key, void* ctx), void* ctx) {
+    int capacity = 64, top = 0;
+    struct CNode** stack = (struct CNode**)malloc(capacity * sizeof(struct CNode*));
+    long visited = 0;
+    int last = lo;
+
+    epoch_enter(&tree->epoch, reader);
+    struct CNode* node = cbst_load(&tree->root);
+    while (node != NULL || top > 0) {
+        // Walk left, skipping subtrees that lie entirely below lo
+        while (node != NULL) {
+            if (node->data < lo) {
+                node = cbst_load(&node->right);
+                continue;
+            }
+            if (top == capacity) {
+                capacity *= 2;
+                stack = (struct CNode**)realloc(stack, capacity * sizeof(struct CNode*));
+            }
+            stack[top++] = node;
+            node = cbst_load(&node->left);
+        }
+        if (top == 0) {
+            break;
+        }
+
+        node = stack[--top];
+        if (node->data > hi) {
+            break;
+        }
+        // A key deleted and re-inserted behind the scan can show up again; keep output strictly increasing
+        if (visited == 0 || node->data > last) {
+            last = node->data;
+            visited++;
+            if (visit(node->data, ctx)) {
+                break;
+            }
+        }
+        node = cbst_load(&node->right);
+    }
+    epoch_exit(&tree->epoch, reader);
+
+    free(stack);
+    return visited;
+}
+
+// Function to get the number of keys in the tree
+long cbst_size(struct ConcurrentBST* tree) {
+    return atomic_load_explicit(&tree->count, memory_order_relaxed);
+}
+
+// Function to insert a key; returns false if it was already present
+bool cbst_insert(struct ConcurrentBST* tree, int key) {
+    pthread_mutex_lock(&tree->write_lock);
+
+    struct CNode* _Atomic* link = &tree->root;
+    struct CNode* node;
+    while ((node = atomic_load_explicit(link, memory_order_relaxed)) != NULL) {
+        if (key == node->data) {
+            pthread_mutex_unlock(&tree->write_lock);
+            return false;
+        }
+        link = key < node->data ? &node->left : &node->right;
+    }
+
+    // The node is fully initialised before the release store makes it reachable
+    cbst_publish(link, cbst_create_node(key, NULL, NULL));
+    atomic_fetch_add_explicit(&tree->count, 1, memory_order_relaxed);
+
+    pthread_mutex_unlock(&tree->write_lock);
+    return true;
+}
+
+// Function to delete a key; returns false if it was not present
+bool cbst_delete(struct ConcurrentBST* tree, int key) {
+    pthread_mutex_lock(&tree->write_lock);
+
+    struct CNode* _Atomic* link = &tree->root;
+    struct CNode* node;
+    while ((node = atomic_load_explicit(link, memory_order_relaxed)) != NULL && node->data != key) {
+        link = key < node->data ? &node->left : &node->right;
+    }
+    if (node == NULL) {
+        pthread_mutex_unlock(&tree->write_lock);
+        return false;
+    }
+
+    struct CNode* left = atomic_load_explicit(&node->left, memory_order_relaxed);
+    struct CNode* right = atomic_load_explicit(&node->right, memory_order_relaxed);
+
+    if (left == NULL || right == NULL) {
+        cbst_publish(link, left != NULL ? left : right);
+        epoch_retire(&tree->epoch, node, free);
+    } else {
+        // Two children: readers must never see the successor missing from both places,
+        // so copy the path from the right child down to the successor and swap it in at once
+        struct CNode* path = right;
+        int depth = 0;
+        while (atomic_load_explicit(&path->left, memory_order_relaxed) != NULL) {
+            path = atomic_load_explicit(&path->left, memory_order_relaxed);
+            depth++;
+        }
+        struct CNode* successor = path;
+        struct CNode* new_right = atomic_load_explicit(&successor->right, memory_order_relaxed);
+
+        if (depth > 0) {
+            // Rebuild the left spine of the right subtree bottom-up, minus the successor
+            struct CNode** spine = (struct CNode**)malloc(depth * sizeof(struct CNode*));
+            path = right;
+            for (int i = 0; i < depth; i++) {
+                spine[i] = path;
+                path = atomic_load_explicit(&path->left, memory_order_relaxed);
+            }
+            for (int i = depth - 1; i >= 0; i--) {
+                new_right = cbst_create_node(spine[i]->data, new_right,
+                                             atomic_load_explicit(&spine[i]->right, memory_order_relaxed));
+            }
+            cbst_publish(link, cbst_create_node(successor->data, left, new_right));
+            for (int i = 0; i < depth; i++) {
+                epoch_retire(&tree->epoch, spine[i], free);
+            }
+            free(spine);
+        } else {
+            cbst_publish(link, cbst_create_node(successor->data, left, new_right));
+        }
+        epoch_retire(&tree->epoch, node, free);
+        epoch_retire(&tree->epoch, successor, free);
+    }
+    atomic_fetch_sub_explicit(&tree->count, 1, memory_order_relaxed);
+
+    pthread_mutex_unlock(&tree->write_lock);
+    return true;
+}
+
+// Function to free the tree; no reader or writer may be active
+void cbst_destroy(struct ConcurrentBST* tree) {
+    int capacity = 64, top = 0;
+    struct CNode** stack = (struct CNode**)malloc(capacity * sizeof(struct CNode*));
+    struct CNode* root = atomic_load(&tree->root);
+
+    if (root != NULL) {
+        stack[top++] = root;
+    }
+    while (top > 0) {
+        struct CNode* node = stack[--top];
+        struct CNode* children[2] = { atomic_load(&node->left), atomic_load(&node->right) };
+        for (int i = 0; i < 2; i++) {
+            if (children[i] != NULL) {
+                if (top == capacity) {
+                    capacity *= 2;
+                    stack = (struct CNode**)realloc(stack, capacity * sizeof(struct CNode*));
+                }
+                stack[top++] = children[i];
+            }
+        }
+        free(node);
+    }
+    free(stack);
+
+    epoch_domain_destroy(&tree->epoch);
+    pthread_mutex_destroy(&tree->write_lock);
+    free(tree);
+}
+
+#endif
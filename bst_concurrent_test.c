@@ -0,0 +1,263 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "bst_concurrent.h"
+
+// Stress test and benchmark driver for bst_concurrent.h. Build with
+//   gcc -std=c11 -O2 bst_concurrent_test.c -pthread -o bst_concurrent_test
+// and run as ./bst_concurrent_test [max_threads]. The stress test runs one writer that
+// toggles keys and logs every change, and readers that check each search and range scan
+// against that log. The benchmark then runs 95/5 and 99/1 read/write mixes for 1, 2, 4,
+// ... up to max_threads threads (32 by default).
+
+#define STRESS_KEYS 64
+#define STRESS_READERS 4
+#define STRESS_WRITES 200000
+#define STRESS_SCAN_WIDTH 16
+
+#define BENCH_KEYS (1 << 20)
+#define BENCH_MILLIS 300
+
+// Writer-side log: stamp[k] is odd while key k is being changed and even otherwise,
+// so the writer has finished stamp[k] / 2 toggles of k and k is present iff that count is odd
+struct StressLog {
+    struct ConcurrentBST* tree;
+    _Atomic uint64_t stamp[STRESS_KEYS];
+    atomic_bool done;
+    atomic_long checked;
+    atomic_long failures;
+};
+
+// Helper for a small deterministic random generator
+uint32_t test_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return (uint32_t)(*state >> 32);
+}
+
+// Helper to read a monotonic clock in milliseconds
+double now_millis(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Helper to check one read of key against the log; only reads that no change overlapped are decided
+void stress_check(struct StressLog* log, uint64_t before, uint64_t after, bool found) {
+    if (before != after || before % 2 != 0) {
+        return;
+    }
+    atomic_fetch_add_explicit(&log->checked, 1, memory_order_relaxed);
+    if (found != ((before / 2) % 2 == 1)) {
+        atomic_fetch_add_explicit(&log->failures, 1, memory_order_relaxed);
+    }
+}
+
+// Helper to mark a key reported by a range scan
+int stress_visit(int key, void* ctx) {
+    bool* seen = (bool*)ctx;
+    seen[key] = true;
+    return 0;
+}
+
+// Function for the single writer: toggle random keys, logging each change around it
+void* stress_writer(void* arg) {
+    struct StressLog* log = (struct StressLog*)arg;
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+
+    for (int i = 0; i < STRESS_WRITES; ++i) {
+        int key = test_random(&state) % STRESS_KEYS;
+        uint64_t stamp = atomic_load(&log->stamp[key]);
+        atomic_store(&log->stamp[key], stamp + 1);
+        if ((stamp / 2) % 2 == 1) {
+            cbst_delete(log->tree, key);
+        } else {
+            cbst_insert(log->tree, key);
+        }
+        atomic_store(&log->stamp[key], stamp + 2);
+    }
+    atomic_store(&log->done, true);
+    return NULL;
+}
+
+// Function for a reader: alternate point lookups and range scans until the writer finishes
+void* stress_reader(void* arg) {
+    struct StressLog* log = (struct StressLog*)arg;
+    int reader = cbst_register_reader(log->tree);
+    uint64_t state = (uint64_t)reader * 0x9E3779B97F4A7C15ull + 1;
+    uint64_t before[STRESS_KEYS];
+    bool seen[STRESS_KEYS];
+
+    while (!atomic_load(&log->done)) {
+        int key = test_random(&state) % STRESS_KEYS;
+        uint64_t stamp = atomic_load(&log->stamp[key]);
+        bool found = cbst_search(log->tree, reader, key);
+        stress_check(log, stamp, atomic_load(&log->stamp[key]), found);
+
+        int lo = test_random(&state) % STRESS_KEYS;
+        int hi = lo + STRESS_SCAN_WIDTH - 1 < STRESS_KEYS ? lo + STRESS_SCAN_WIDTH - 1 : STRESS_KEYS - 1;
+        for (int k = lo; k <= hi; ++k) {
+            before[k] = atomic_load(&log->stamp[k]);
+            seen[k] = false;
+        }
+        cbst_range_scan(log->tree, reader, lo, hi, stress_visit, seen);
+        for (int k = lo; k <= hi; ++k) {
+            stress_check(log, before[k], atomic_load(&log->stamp[k]), seen[k]);
+        }
+    }
+
+    cbst_unregister_reader(log->tree, reader);
+    return NULL;
+}
+
+// Function to run the linearizability stress test; returns true if every decided read agreed with the log
+bool test_linearizable(void) {
+    struct StressLog* log = (struct StressLog*)malloc(sizeof(struct StressLog));
+    pthread_t writer, readers[STRESS_READERS];
+
+    log->tree = cbst_create();
+    for (int k = 0; k < STRESS_KEYS; ++k) {
+        atomic_init(&log->stamp[k], 0);
+    }
+    atomic_init(&log->done, false);
+    atomic_init(&log->checked, 0);
+    atomic_init(&log->failures, 0);
+
+    for (int i = 0; i < STRESS_READERS; ++i) {
+        pthread_create(&readers[i], NULL, stress_reader, log);
+    }
+    pthread_create(&writer, NULL, stress_writer, log);
+    pthread_join(writer, NULL);
+    for (int i = 0; i < STRESS_READERS; ++i) {
+        pthread_join(readers[i], NULL);
+    }
+
+    // Quiescent check: the final tree must match the log exactly
+    long expected = 0;
+    int reader = cbst_register_reader(log->tree);
+    for (int k = 0; k < STRESS_KEYS; ++k) {
+        bool present = (atomic_load(&log->stamp[k]) / 2) % 2 == 1;
+        expected += present;
+        if (cbst_search(log->tree, reader, k) != present) {
+            atomic_fetch_add(&log->failures, 1);
+        }
+    }
+    cbst_unregister_reader(log->tree, reader);
+    if (cbst_size(log->tree) != expected) {
+        atomic_fetch_add(&log->failures, 1);
+    }
+
+    long failures = atomic_load(&log->failures);
+    printf("Stress: %d writes, %ld reads checked against the log, %ld mismatches\n",
+           STRESS_WRITES, atomic_load(&log->checked), failures);
+    cbst_destroy(log->tree);
+    free(log);
+    return failures == 0;
+}
+
+// Structure for one benchmark thread
+struct BenchWorker {
+    struct ConcurrentBST* tree;
+    atomic_bool* stop;
+    int read_percent;
+    uint64_t seed;
+    long ops;
+};
+
+// Function for a benchmark thread: random searches, inserts and deletes until stopped
+void* bench_worker(void* arg) {
+    struct BenchWorker* worker = (struct BenchWorker*)arg;
+    int reader = cbst_register_reader(worker->tree);
+    uint64_t state = worker->seed;
+    long ops = 0;
+
+    while (!atomic_load_explicit(worker->stop, memory_order_relaxed)) {
+        uint32_t roll = test_random(&state);
+        int key = test_random(&state) % BENCH_KEYS;
+        if ((int)(roll % 100) < worker->read_percent) {
+            cbst_search(worker->tree, reader, key);
+        } else if (roll & (1u << 31)) {
+            cbst_insert(worker->tree, key);
+        } else {
+            cbst_delete(worker->tree, key);
+        }
+        ops++;
+    }
+
+    cbst_unregister_reader(worker->tree, reader);
+    worker->ops = ops;
+    return NULL;
+}
+
+// Function to measure throughput of one read/write mix with the given number of threads
+double bench_mix(struct ConcurrentBST* tree, int threads, int read_percent) {
+    pthread_t* ids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    struct BenchWorker* workers = (struct BenchWorker*)malloc(threads * sizeof(struct BenchWorker));
+    atomic_bool stop;
+    long total = 0;
+
+    atomic_init(&stop, false);
+    double start = now_millis();
+    for (int i = 0; i < threads; ++i) {
+        workers[i] = (struct BenchWorker){ tree, &stop, read_percent, 0x9E3779B97F4A7C15ull * (i + 1), 0 };
+        pthread_create(&ids[i], NULL, bench_worker, &workers[i]);
+    }
+    struct timespec pause = { BENCH_MILLIS / 1000, (BENCH_MILLIS % 1000) * 1000000L };
+    nanosleep(&pause, NULL);
+    atomic_store(&stop, true);
+    for (int i = 0; i < threads; ++i) {
+        pthread_join(ids[i], NULL);
+        total += workers[i].ops;
+    }
+    double elapsed = now_millis() - start;
+
+    free(workers);
+    free(ids);
+    return total / elapsed / 1e3;
+}
+
+// Function to run the read-heavy benchmark over a half-full tree of BENCH_KEYS keys
+void run_benchmark(int max_threads) {
+    const int mixes[] = { 95, 99 };
+    struct ConcurrentBST* tree = cbst_create();
+    uint64_t state = 0xDEADBEEFCAFEull;
+
+    // Random insertion order keeps the unbalanced tree at logarithmic depth
+    while (cbst_size(tree) < BENCH_KEYS / 2) {
+        cbst_insert(tree, test_random(&state) % BENCH_KEYS);
+    }
+
+    printf("%-10s", "threads");
+    for (int m = 0; m < 2; ++m) {
+        printf("  %2d/%-2d Mops/s", mixes[m], 100 - mixes[m]);
+    }
+    printf("\n");
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        printf("%-10d", threads);
+        for (int m = 0; m < 2; ++m) {
+            printf("  %12.2f", bench_mix(tree, threads, mixes[m]));
+        }
+        printf("\n");
+    }
+    cbst_destroy(tree);
+}
+
+int main(int argc, char* argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : 32;
+    if (max_threads < 1 || max_threads >= EPOCH_MAX_THREADS) {
+        printf("max_threads must be between 1 and %d\n", EPOCH_MAX_THREADS - 1);
+        return 1;
+    }
+
+    bool ok = test_linearizable();
+    if (ok) {
+        run_benchmark(max_threads);
+    }
+
+    printf(ok ? "All concurrent BST tests passed\n" : "Concurrent BST tests failed\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#ifndef BST_EYTZINGER_H
+#define BST_EYTZINGER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bst.h"
+
+// Number of lookups interleaved by frozen_search_many
+#define FROZEN_BATCH 16
+
+#if defined(__GNUC__)
+#define FROZEN_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define FROZEN_PREFETCH(addr) ((void)0)
+#endif
+
+// Read-only copy of a BST stored in Eytzinger (BFS) order: the children of
+// keys[k] are keys[2k] and keys[2k + 1], keys[0] is unused.
+struct FrozenBST {
+    int* keys;
+    int n;
+};
+
+// Helper to lay out sorted keys in Eytzinger order
+void frozen_fill(struct FrozenBST* frozen, const int* sorted, int* next, int k) {
+    if (k <= frozen->n) {
+        frozen_fill(frozen, sorted, next, 2 * k);
+        frozen->keys[k] = sorted[(*next)++];
+        frozen_fill(frozen, sorted, next, 2 * k + 1);
+    }
+}
+
+// Helper for freeze: append each key to a sorted array
+int frozen_collect(int key, void* ctx) {
+    int** out = (int**)ctx;
+    *(*out)++ = key;
+    return 0;
+}
+
+// Function to build a frozen snapshot from keys sorted in strictly ascending order
+struct FrozenBST* freeze_sorted(const int* sorted, int n) {
+    struct FrozenBST* frozen = (struct FrozenBST*)malloc(sizeof(struct FrozenBST));
+    // Align so the 16 keys four levels below any node share one cache line
+    size_t bytes = ((size_t)n + 1) * sizeof(int);
+    bytes = (bytes + 63) / 64 * 64;
+    frozen->keys = (int*)aligned_alloc(64, bytes);
+    frozen->keys[0] = 0;
+    frozen->n = n;
+
+    int next = 0;
+    frozen_fill(frozen, sorted, &next, 1);
+    return frozen;
+}
+
+// Function to convert a tree into a frozen snapshot; the tree itself is left untouched
+struct FrozenBST* freeze(struct Node* root) {
+    int n = size(root);
+    int* sorted = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    int* out = sorted;
+
+    bst_for_each(root, frozen_collect, &out);
+    struct FrozenBST* frozen = freeze_sorted(sorted, n);
+
+    free(sorted);
+    return frozen;
+}
+
+// Helper to turn a finished descent into the index of the lower bound (0 if every key is smaller)
+size_t frozen_resolve(size_t k) {
+    // Strip the trailing right turns and the last left turn
+#if defined(__GNUC__)
+    return k >> __builtin_ffsll((long long)~k);
+#else
+    while (k & 1) {
+        k >>= 1;
+    }
+    return k >> 1;
+#endif
+}
+
+// Function to find the index of the first key >= key, or 0 if there is none
+size_t frozen_lower_bound(const struct FrozenBST* frozen, int key) {
+    const int* keys = frozen->keys;
+    size_t n = (size_t)frozen->n;
+    size_t k = 1;
+
+    while (k <= n) {
+        FROZEN_PREFETCH(keys + 16 * k);
+        k = 2 * k + (keys[k] < key);
+    }
+    return frozen_resolve(k);
+}
+
+// Function to search for a key with a branchless descent
+bool frozen_search(const struct FrozenBST* frozen, int key) {
+    size_t k = frozen_lower_bound(frozen, key);
+    return k != 0 && frozen->keys[k] == key;
+}
+
+// Function to look up many keys at once; found[i] is set for each query present in the snapshot.
+// Lookups advance level by level in groups so the memory loads of one group overlap.
+void frozen_search_many(const struct FrozenBST* frozen, const int* queries, int count, bool* found) {
+    const int* keys = frozen->keys;
+    size_t n = (size_t)frozen->n;
+    int levels = 0;
+    while (((size_t)1 << levels) <= n) {
+        levels++;
+    }
+
+    for (int base = 0; base < count; base += FROZEN_BATCH) {
+        int lanes = count - base < FROZEN_BATCH ? count - base : FROZEN_BATCH;
+        size_t k[FROZEN_BATCH];
+
+        for (int j = 0; j < lanes; j++) {
+            k[j] = 1;
+        }
+        for (int level = 0; level < levels; level++) {
+            for (int j = 0; j < lanes; j++) {
+                // Lanes that already fell off the bottom stay put; keys[0] is a safe dummy read
+                size_t cur = k[j];
+                bool active = cur <= n;
+                int value = keys[active ? cur : 0];
+                size_t next = 2 * cur + (value < queries[base + j]);
+                k[j] = active ? next : cur;
+                FROZEN_PREFETCH(keys + 16 * k[j]);
+            }
+        }
+        for (int j = 0; j < lanes; j++) {
+            size_t index = frozen_resolve(k[j]);
+            found[base + j] = index != 0 && keys[index] == queries[base + j];
+        }
+    }
+}
+
+// Function to free a frozen snapshot
+void frozen_destroy(struct FrozenBST* frozen) {
+    free(frozen->keys);
+    free(frozen);
+}
+
+#endif
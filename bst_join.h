@@ -0,0 +1,287 @@
+#ifndef BST_JOIN_H
+#define BST_JOIN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "bst.h"
+#include "parallel.h"
+
+// Join-based set operations on bst.h trees, kept weight-balanced through the
+// subtree sizes stored in every node. All operations consume their input trees
+// and reuse their nodes. Inputs should be balanced (e.g. with rebuild() or
+// build_balanced()) for the O(m log(n/m + 1)) bounds to hold; unbalanced inputs
+// still give correct results.
+
+// Weight-balance parameters (delta, ratio) = (3, 2)
+#define JOIN_DELTA 3
+#define JOIN_RATIO 2
+
+// Subtrees smaller than this are processed on the calling thread
+#define JOIN_PARALLEL_CUTOFF 4096
+
+// Helper to attach children to a node and refresh its size
+struct Node* join_make(struct Node* node, struct Node* left, struct Node* right) {
+    node->left = left;
+    node->right = right;
+    update_size(node);
+    return node;
+}
+
+// Helper to rotate left around node
+struct Node* join_rotate_left(struct Node* node) {
+    struct Node* right = node->right;
+    join_make(node, node->left, right->left);
+    return join_make(right, node, right->right);
+}
+
+// Helper to rotate right around node
+struct Node* join_rotate_right(struct Node* node) {
+    struct Node* left = node->left;
+    join_make(node, left->right, node->right);
+    return join_make(left, left->left, node);
+}
+
+// Helper to restore weight balance at a node whose children differ by at most one step
+struct Node* join_balance(struct Node* node) {
+    int size_l = node_size(node->left);
+    int size_r = node_size(node->right);
+
+    if (size_l + size_r <= 1) {
+        return node;
+    }
+    if (size_r > JOIN_DELTA * size_l) {
+        struct Node* right = node->right;
+        if (node_size(right->left) >= JOIN_RATIO * node_size(right->right)) {
+            node->right = join_rotate_right(right);
+        }
+        return join_rotate_left(node);
+    }
+    if (size_l > JOIN_DELTA * size_r) {
+        struct Node* left = node->left;
+        if (node_size(left->right) >= JOIN_RATIO * node_size(left->left)) {
+            node->left = join_rotate_left(left);
+        }
+        return join_rotate_right(node);
+    }
+    return node;
+}
+
+// Helper to add node as the new minimum of a tree
+struct Node* join_insert_min(struct Node* node, struct Node* root) {
+    if (root == NULL) {
+        return join_make(node, NULL, NULL);
+    }
+    root->left = join_insert_min(node, root->left);
+    update_size(root);
+    return join_balance(root);
+}
+
+// Helper to add node as the new maximum of a tree
+struct Node* join_insert_max(struct Node* node, struct Node* root) {
+    if (root == NULL) {
+        return join_make(node, NULL, NULL);
+    }
+    root->right = join_insert_max(node, root->right);
+    update_size(root);
+    return join_balance(root);
+}
+
+// Function to join left, node and right into one balanced tree; every key in left must be
+// smaller than node->data and every key in right larger
+struct Node* join(struct Node* left, struct Node* node, struct Node* right) {
+    if (left == NULL) {
+        return join_insert_min(node, right);
+    }
+    if (right == NULL) {
+        return join_insert_max(node, left);
+    }
+
+    int size_l = left->size;
+    int size_r = right->size;
+    if (JOIN_DELTA * size_l < size_r) {
+        // Right side is much heavier: descend its left spine
+        right->left = join(left, node, right->left);
+        update_size(right);
+        return join_balance(right);
+    }
+    if (JOIN_DELTA * size_r < size_l) {
+        // Left side is much heavier: descend its right spine
+        left->right = join(left->right, node, right);
+        update_size(left);
+        return join_balance(left);
+    }
+    return join_make(node, left, right);
+}
+
+// Helper to detach the maximum node of a tree; returns the rest and sets *max
+struct Node* join_split_last(struct Node* root, struct Node** max) {
+    if (root->right == NULL) {
+        *max = root;
+        return root->left;
+    }
+    struct Node* rest = join_split_last(root->right, max);
+    return join(root->left, root, rest);
+}
+
+// Function to join two trees where every key in left is smaller than every key in right
+struct Node* join2(struct Node* left, struct Node* right) {
+    if (left == NULL) {
+        return right;
+    }
+    struct Node* max;
+    struct Node* rest = join_split_last(left, &max);
+    return join(rest, max, right);
+}
+
+// Function to split a tree around key into keys < key (*left) and keys > key (*right).
+// Returns the detached node holding key, or NULL if key was absent.
+struct Node* split(struct Node* root, int key, struct Node** left, struct Node** right) {
+    if (root == NULL) {
+        *left = *right = NULL;
+        return NULL;
+    }
+
+    struct Node* found;
+    if (key < root->data) {
+        struct Node* inner_right;
+        found = split(root->left, key, left, &inner_right);
+        *right = join(inner_right, root, root->right);
+    } else if (key > root->data) {
+        struct Node* inner_left;
+        found = split(root->right, key, &inner_left, right);
+        *left = join(root->left, root, inner_left);
+    } else {
+        *left = root->left;
+        *right = root->right;
+        found = join_make(root, NULL, NULL);
+    }
+    return found;
+}
+
+// Arguments and result of one recursive set operation, so halves can run on other threads
+struct JoinTask {
+    struct Node* a;
+    struct Node* b;
+    int (*keep)(int key, void* ctx);
+    void* ctx;
+    struct Node* result;
+};
+
+struct Node* set_union(struct Node* a, struct Node* b);
+struct Node* set_intersection(struct Node* a, struct Node* b);
+struct Node* set_difference(struct Node* a, struct Node* b);
+struct Node* set_filter(struct Node* root, int (*keep)(int key, void* ctx), void* ctx);
+
+void join_union_task(void* task) {
+    struct JoinTask* t = (struct JoinTask*)task;
+    t->result = set_union(t->a, t->b);
+}
+
+void join_intersection_task(void* task) {
+    struct JoinTask* t = (struct JoinTask*)task;
+    t->result = set_intersection(t->a, t->b);
+}
+
+void join_difference_task(void* task) {
+    struct JoinTask* t = (struct JoinTask*)task;
+    t->result = set_difference(t->a, t->b);
+}
+
+void join_filter_task(void* task) {
+    struct JoinTask* t = (struct JoinTask*)task;
+    t->result = set_filter(t->a, t->keep, t->ctx);
+}
+
+// Helper to run the two recursive halves, in parallel when they are large enough
+void join_fork(void (*fn)(void*), struct JoinTask* left, struct JoinTask* right) {
+    if (node_size(left->a) + node_size(left->b) + node_size(right->a) + node_size(right->b) >= JOIN_PARALLEL_CUTOFF) {
+        parallel_invoke(fn, left, fn, right);
+    } else {
+        fn(left);
+        fn(right);
+    }
+}
+
+// Function to compute the union of two trees; both inputs are consumed
+struct Node* set_union(struct Node* a, struct Node* b) {
+    if (a == NULL) {
+        return b;
+    }
+    if (b == NULL) {
+        return a;
+    }
+
+    struct Node* b_left;
+    struct Node* b_right;
+    struct Node* duplicate = split(b, a->data, &b_left, &b_right);
+    free(duplicate);
+
+    struct JoinTask left = { a->left, b_left, NULL, NULL, NULL };
+    struct JoinTask right = { a->right, b_right, NULL, NULL, NULL };
+    join_fork(join_union_task, &left, &right);
+    return join(left.result, a, right.result);
+}
+
+// Function to compute the intersection of two trees; both inputs are consumed
+struct Node* set_intersection(struct Node* a, struct Node* b) {
+    if (a == NULL || b == NULL) {
+        clear(a);
+        clear(b);
+        return NULL;
+    }
+
+    struct Node* b_left;
+    struct Node* b_right;
+    struct Node* duplicate = split(b, a->data, &b_left, &b_right);
+
+    struct JoinTask left = { a->left, b_left, NULL, NULL, NULL };
+    struct JoinTask right = { a->right, b_right, NULL, NULL, NULL };
+    join_fork(join_intersection_task, &left, &right);
+
+    if (duplicate != NULL) {
+        free(duplicate);
+        return join(left.result, a, right.result);
+    }
+    free(a);
+    return join2(left.result, right.result);
+}
+
+// Function to compute the keys of a that are not in b; both inputs are consumed
+struct Node* set_difference(struct Node* a, struct Node* b) {
+    if (a == NULL || b == NULL) {
+        clear(b);
+        return a;
+    }
+
+    struct Node* a_left;
+    struct Node* a_right;
+    struct Node* duplicate = split(a, b->data, &a_left, &a_right);
+    free(duplicate);
+
+    struct JoinTask left = { a_left, b->left, NULL, NULL, NULL };
+    struct JoinTask right = { a_right, b->right, NULL, NULL, NULL };
+    free(b);
+    join_fork(join_difference_task, &left, &right);
+    return join2(left.result, right.result);
+}
+
+// Function to keep only the keys for which keep(key, ctx) is non-zero; the input is consumed.
+// keep may be called from several threads at once.
+struct Node* set_filter(struct Node* root, int (*keep)(int key, void* ctx), void* ctx) {
+    if (root == NULL) {
+        return NULL;
+    }
+
+    struct JoinTask left = { root->left, NULL, keep, ctx, NULL };
+    struct JoinTask right = { root->right, NULL, keep, ctx, NULL };
+    join_fork(join_filter_task, &left, &right);
+
+    if (keep(root->data, ctx)) {
+        return join(left.result, root, right.result);
+    }
+    free(root);
+    return join2(left.result, right.result);
+}
+
+#endif
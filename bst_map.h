@@ -0,0 +1,191 @@
+#ifndef BST_MAP_H
+#define BST_MAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Generic ordered key/value map built on an unbalanced BST.
+//
+// BST_MAP_DEFINE(name, K, V, CMP) generates struct name, struct name##_node
+// and name##_* functions for key type K and value type V. CMP(a, b) is a
+// macro returning <0, 0 or >0; it is expanded inline into every descent, so
+// lookups make no indirect calls. Example:
+//
+//     BST_MAP_DEFINE(id_map, int64_t, double, BST_MAP_CMP_NUM)
+//
+//     struct id_map map;
+//     id_map_init(&map);
+//     id_map_insert_or_assign(&map, 42, 1.5);
+//     double* value = id_map_get(&map, 42);
+
+// Three-way comparison for integer and floating-point keys (NaN keys are not supported)
+#define BST_MAP_CMP_NUM(a, b) (((a) > (b)) - ((a) < (b)))
+
+// Three-way comparison for keys declared with BST_MAP_BYTES_KEY
+#define BST_MAP_CMP_BYTES(a, b) memcmp((a).bytes, (b).bytes, sizeof((a).bytes))
+
+// Declares a fixed-length byte string key type, compared lexicographically by BST_MAP_CMP_BYTES
+#define BST_MAP_BYTES_KEY(type, length) \
+    struct type {                       \
+        unsigned char bytes[length];    \
+    }
+
+#define BST_MAP_DEFINE(name, K, V, CMP)                                                          \
+                                                                                                 \
+    struct name##_node {                                                                         \
+        K key;                                                                                   \
+        V value;                                                                                 \
+        struct name##_node* left;                                                                \
+        struct name##_node* right;                                                               \
+    };                                                                                           \
+                                                                                                 \
+    struct name {                                                                                \
+        struct name##_node* root;                                                                \
+        size_t size;                                                                             \
+    };                                                                                           \
+                                                                                                 \
+    /* Function to initialise an empty map */                                                    \
+    static inline void name##_init(struct name* map) {                                           \
+        map->root = NULL;                                                                        \
+        map->size = 0;                                                                           \
+    }                                                                                            \
+                                                                                                 \
+    /* Helper to find the link that holds key, or the empty link where it would go */            \
+    static inline struct name##_node** name##_find_link(struct name* map, K key) {               \
+        struct name##_node** link = &map->root;                                                  \
+        while (*link != NULL) {                                                                  \
+            int cmp = CMP(key, (*link)->key);                                                    \
+            if (cmp == 0) {                                                                      \
+                break;                                                                           \
+            }                                                                                    \
+            link = cmp < 0 ? &(*link)->left : &(*link)->right;                                   \
+        }                                                                                        \
+        return link;                                                                             \
+    }                                                                                            \
+                                                                                                 \
+    /* Helper to hang a new node off an empty link */                                            \
+    static inline struct name##_node* name##_attach(struct name* map, struct name##_node** link, \
+                                                    K key, V value) {                            \
+        struct name##_node* node = (struct name##_node*)malloc(sizeof(struct name##_node));      \
+        node->key = key;                                                                         \
+        node->value = value;                                                                     \
+        node->left = node->right = NULL;                                                         \
+        *link = node;                                                                            \
+        map->size++;                                                                             \
+        return node;                                                                             \
+    }                                                                                            \
+                                                                                                 \
+    /* Function to get a pointer to the value stored for key, or NULL */                         \
+    static inline V* name##_get(struct name* map, K key) {                                       \
+        struct name##_node* node = map->root;                                                    \
+        while (node != NULL) {                                                                   \
+            int cmp = CMP(key, node->key);                                                       \
+            if (cmp == 0) {                                                                      \
+                return &node->value;                                                             \
+            }                                                                                    \
+            node = cmp < 0 ? node->left : node->right;                                           \
+        }                                                                                        \
+        return NULL;                                                                             \
+    }                                                                                            \
+                                                                                                 \
+    /* Function to check whether key is present */                                               \
+    static inline bool name##_contains(struct name* map, K key) {                                \
+        return name##_get(map, key) != NULL;                                                     \
+    }                                                                                            \
+                                                                                                 \
+    /* Function to store value under key in one descent; returns true if key was new */          \
+    static inline bool name##_insert_or_assign(struct name* map, K key, V value) {               \
+        struct name##_node** link = name##_find_link(map, key);                                  \
+        if (*link != NULL) {                                                                     \
+            (*link)->value = value;                                                              \
+            return false;                                                                        \
+        }                                                                                        \
+        name##_attach(map, link, key, value);                                                    \
+        return true;                                                                             \
+    }                                                                                            \
+                                                                                                 \
+    /* Function to get the value for key, inserting initial first if absent, in one descent */   \
+    static inline V* name##_get_or_insert(struct name* map, K key, V initial, bool* inserted) {  \
+        struct name##_node** link = name##_find_link(map, key);                                  \
+        bool is_new = *link == NULL;                                                             \
+        if (is_new) {                                                                            \
+            name##_attach(map, link, key, initial);                                              \
+        }                                                                                        \
+        if (inserted != NULL) {                                                                  \
+            *inserted = is_new;                                                                  \
+        }                                                                                        \
+        return &(*link)->value;                                                                  \
+    }                                                                                            \
+                                                                                                 \
+    /* Function to remove key, copying its value to out if given; returns false if absent */     \
+    static inline bool name##_remove(struct name* map, K key, V* out) {                          \
+        struct name##_node** link = name##_find_link(map, key);                                  \
+        struct name##_node* node = *link;                                                        \
+        if (node == NULL) {                                                                      \
+            return false;                                                                        \
+        }                                                                                        \
+        if (out != NULL) {                                                                       \
+            *out = node->value;                                                                  \
+        }                                                                                        \
+        if (node->left != NULL && node->right != NULL) {                                         \
+            /* Two children: move the inorder successor's entry here and unlink it instead */    \
+            struct name##_node** succ_link = &node->right;                                       \
+            while ((*succ_link)->left != NULL) {                                                 \
+                succ_link = &(*succ_link)->left;                                                 \
+            }                                                                                    \
+            link = succ_link;                                                                    \
+            node->key = (*link)->key;                                                            \
+            node->value = (*link)->value;                                                        \
+            node = *link;                                                                        \
+        }                                                                                        \
+        *link = node->left != NULL ? node->left : node->right;                                   \
+        free(node);                                                                              \
+        map->size--;                                                                             \
+        return true;                                                                             \
+    }                                                                                            \
+                                                                                                 \
+    /* Function to find the entry with the smallest key, or NULL if the map is empty */          \
+    static inline struct name##_node* name##_min(struct name* map) {                             \
+        struct name##_node* node = map->root;                                                    \
+        while (node != NULL && node->left != NULL) {                                             \
+            node = node->left;                                                                   \
+        }                                                                                        \
+        return node;                                                                             \
+    }                                                                                            \
+                                                                                                 \
+    /* Function to find the entry with the largest key, or NULL if the map is empty */           \
+    static inline struct name##_node* name##_max(struct name* map) {                             \
+        struct name##_node* node = map->root;                                                    \
+        while (node != NULL && node->right != NULL) {                                            \
+            node = node->right;                                                                  \
+        }                                                                                        \
+        return node;                                                                             \
+    }                                                                                            \
+                                                                                                 \
+    /* Function to get the number of entries */                                                  \
+    static inline size_t name##_size(struct name* map) {                                         \
+        return map->size;                                                                        \
+    }                                                                                            \
+                                                                                                 \
+    /* Function to free every entry; flattens with rotations so no stack is needed */            \
+    static inline void name##_clear(struct name* map) {                                          \
+        struct name##_node* node = map->root;                                                    \
+        while (node != NULL) {                                                                   \
+            if (node->left != NULL) {                                                            \
+                struct name##_node* left = node->left;                                           \
+                node->left = left->right;                                                        \
+                left->right = node;                                                              \
+                node = left;                                                                     \
+            } else {                                                                             \
+                struct name##_node* right = node->right;                                         \
+                free(node);                                                                      \
+                node = right;                                                                    \
+            }                                                                                    \
+        }                                                                                        \
+        map->root = NULL;                                                                        \
+        map->size = 0;                                                                           \
+    }
+
+#endif
@@ -0,0 +1,297 @@
+#ifndef BST_PERSISTENT_H
+#define BST_PERSISTENT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Persistent (path-copying) BST. Nodes are immutable once built and shared
+// between versions; a version is just a root pointer that holds one reference.
+// Versions are kept weight-balanced with the same (delta, ratio) = (3, 2) rule as
+// bst_join.h, so an update copies O(log n) nodes along the path to the changed key.
+
+// Weight-balance parameters, as in bst_join.h
+#define PBST_DELTA 3
+#define PBST_RATIO 2
+
+// Bound on the height of a weight-balanced version: a child holds at most 3/4 of
+// its parent's keys, so int-sized trees stay below log_{4/3}(2^31) + 1 < 80 levels
+#define PBST_MAX_HEIGHT 96
+
+// Structure for a node in the persistent BST
+struct PNode {
+    int data;
+    int size; // Number of nodes in the subtree rooted here
+    atomic_int refs;
+    struct PNode* left;
+    struct PNode* right;
+};
+
+// Structure holding the latest version, for a writer publishing to many readers
+struct PersistentBST {
+    struct PNode* current;
+    pthread_mutex_t lock;
+};
+
+// Function to get the number of keys in a version in O(1)
+int pbst_size(struct PNode* root) {
+    return root == NULL ? 0 : root->size;
+}
+
+// Function to create a node that takes over the given child references
+struct PNode* pbst_make_node(int data, struct PNode* left, struct PNode* right) {
+    struct PNode* node = (struct PNode*)malloc(sizeof(struct PNode));
+    node->data = data;
+    node->size = 1 + pbst_size(left) + pbst_size(right);
+    atomic_init(&node->refs, 1);
+    node->left = left;
+    node->right = right;
+    return node;
+}
+
+// Function to take an extra reference to a version (an O(1) snapshot)
+struct PNode* pbst_retain(struct PNode* root) {
+    if (root != NULL) {
+        atomic_fetch_add_explicit(&root->refs, 1, memory_order_relaxed);
+    }
+    return root;
+}
+
+// Function to drop a reference; nodes no longer shared with any other version are freed
+void pbst_release(struct PNode* root) {
+    int capacity = 64, top = 0;
+    struct PNode** stack = NULL;
+
+    while (root != NULL) {
+        struct PNode* next = NULL;
+        if (atomic_fetch_sub_explicit(&root->refs, 1, memory_order_acq_rel) == 1) {
+            // Last reference: release both children, one now and one later
+            if (root->right != NULL) {
+                if (stack == NULL) {
+                    stack = (struct PNode**)malloc(capacity * sizeof(struct PNode*));
+                } else if (top == capacity) {
+                    capacity *= 2;
+                    stack = (struct PNode**)realloc(stack, capacity * sizeof(struct PNode*));
+                }
+                stack[top++] = root->right;
+            }
+            next = root->left;
+            free(root);
+        }
+        root = next != NULL ? next : (top > 0 ? stack[--top] : NULL);
+    }
+    free(stack);
+}
+
+// Function to search a version for a key
+struct PNode* pbst_search(struct PNode* root, int key) {
+    while (root != NULL && root->data != key) {
+        root = key < root->data ? root->left : root->right;
+    }
+    return root;
+}
+
+// Function to find the node with the minimum value in a version
+struct PNode* pbst_find_min(struct PNode* root) {
+    while (root != NULL && root->left != NULL) {
+        root = root->left;
+    }
+    return root;
+}
+
+// Function to find the node with the maximum value in a version
+struct PNode* pbst_find_max(struct PNode* root) {
+    while (root != NULL && root->right != NULL) {
+        root = root->right;
+    }
+    return root;
+}
+
+// Helper to build a node from owned child references, copying at most two more nodes
+// to restore weight balance after one side changed by a single key
+struct PNode* pbst_balance(int data, struct PNode* left, struct PNode* right) {
+    int size_l = pbst_size(left);
+    int size_r = pbst_size(right);
+
+    if (size_l + size_r <= 1) {
+        return pbst_make_node(data, left, right);
+    }
+    if (size_r > PBST_DELTA * size_l) {
+        struct PNode* inner = right->left;
+        struct PNode* outer = right->right;
+        struct PNode* root;
+        if (pbst_size(inner) < PBST_RATIO * pbst_size(outer)) {
+            // Single rotation: right's key moves to the top
+            root = pbst_make_node(right->data, pbst_make_node(data, left, pbst_retain(inner)), pbst_retain(outer));
+        } else {
+            // Double rotation: right->left's key moves to the top
+            root = pbst_make_node(inner->data, pbst_make_node(data, left, pbst_retain(inner->left)),
+                                  pbst_make_node(right->data, pbst_retain(inner->right), pbst_retain(outer)));
+        }
+        pbst_release(right);
+        return root;
+    }
+    if (size_l > PBST_DELTA * size_r) {
+        struct PNode* inner = left->right;
+        struct PNode* outer = left->left;
+        struct PNode* root;
+        if (pbst_size(inner) < PBST_RATIO * pbst_size(outer)) {
+            root = pbst_make_node(left->data, pbst_retain(outer), pbst_make_node(data, pbst_retain(inner), right));
+        } else {
+            root = pbst_make_node(inner->data, pbst_make_node(left->data, pbst_retain(outer), pbst_retain(inner->left)),
+                                  pbst_make_node(data, pbst_retain(inner->right), right));
+        }
+        pbst_release(left);
+        return root;
+    }
+    return pbst_make_node(data, left, right);
+}
+
+// Helper to copy the recorded path bottom-up above a rebuilt subtree for key
+struct PNode* pbst_rebuild_path(struct PNode** path, int depth, int key, struct PNode* subtree) {
+    while (depth > 0) {
+        struct PNode* node = path[--depth];
+        if (key < node->data) {
+            subtree = pbst_balance(node->data, subtree, pbst_retain(node->right));
+        } else {
+            subtree = pbst_balance(node->data, pbst_retain(node->left), subtree);
+        }
+    }
+    return subtree;
+}
+
+// Function to insert a key; returns a new version and leaves root unchanged
+struct PNode* pbst_insert(struct PNode* root, int key) {
+    struct PNode* path[PBST_MAX_HEIGHT];
+    int depth = 0;
+
+    for (struct PNode* node = root; node != NULL; node = key < node->data ? node->left : node->right) {
+        if (node->data == key) {
+            return pbst_retain(root);
+        }
+        path[depth++] = node;
+    }
+    return pbst_rebuild_path(path, depth, key, pbst_make_node(key, NULL, NULL));
+}
+
+// Function to delete a key; returns a new version and leaves root unchanged
+struct PNode* pbst_delete(struct PNode* root, int key) {
+    struct PNode* path[PBST_MAX_HEIGHT];
+    int depth = 0;
+    struct PNode* node = root;
+
+    while (node != NULL && node->data != key) {
+        path[depth++] = node;
+        node = key < node->data ? node->left : node->right;
+    }
+    if (node == NULL) {
+        return pbst_retain(root);
+    }
+
+    struct PNode* replacement;
+    if (node->left == NULL || node->right == NULL) {
+        replacement = pbst_retain(node->left != NULL ? node->left : node->right);
+    } else {
+        // Node with two children: the inorder successor takes its place in the copy,
+        // and the left spine down to it is copied without it
+        struct PNode* spine[PBST_MAX_HEIGHT];
+        int length = 0;
+        struct PNode* successor = node->right;
+        while (successor->left != NULL) {
+            spine[length++] = successor;
+            successor = successor->left;
+        }
+        struct PNode* rest = pbst_retain(successor->right);
+        while (length > 0) {
+            struct PNode* above = spine[--length];
+            rest = pbst_balance(above->data, rest, pbst_retain(above->right));
+        }
+        replacement = pbst_balance(successor->data, pbst_retain(node->left), rest);
+    }
+    return pbst_rebuild_path(path, depth, key, replacement);
+}
+
+// Function to call visit on every key of a version in [lo, hi] in order; stops early if visit returns non-zero
+int pbst_range_scan(struct PNode* root, int lo, int hi, int (*visit)(int key, void* ctx), void* ctx) {
+    int capacity = 64, top = 0, visited = 0;
+    struct PNode** stack = (struct PNode**)malloc(capacity * sizeof(struct PNode*));
+
+    while (root != NULL || top > 0) {
+        while (root != NULL) {
+            if (root->data < lo) {
+                root = root->right;
+                continue;
+            }
+            if (top == capacity) {
+                capacity *= 2;
+                stack = (struct PNode**)realloc(stack, capacity * sizeof(struct PNode*));
+            }
+            stack[top++] = root;
+            root = root->left;
+        }
+        if (top == 0) {
+            break;
+        }
+
+        root = stack[--top];
+        if (root->data > hi) {
+            break;
+        }
+        visited++;
+        if (visit(root->data, ctx)) {
+            break;
+        }
+        root = root->right;
+    }
+
+    free(stack);
+    return visited;
+}
+
+// Function to create an empty published tree
+struct PersistentBST* pbst_create(void) {
+    struct PersistentBST* tree = (struct PersistentBST*)malloc(sizeof(struct PersistentBST));
+    tree->current = NULL;
+    pthread_mutex_init(&tree->lock, NULL);
+    return tree;
+}
+
+// Function to take a consistent snapshot of the latest version; release it with pbst_release
+struct PNode* pbst_snapshot(struct PersistentBST* tree) {
+    pthread_mutex_lock(&tree->lock);
+    struct PNode* root = pbst_retain(tree->current);
+    pthread_mutex_unlock(&tree->lock);
+    return root;
+}
+
+// Helper to replace the latest version, dropping the tree's reference to the old one
+void pbst_publish(struct PersistentBST* tree, struct PNode* root) {
+    pthread_mutex_lock(&tree->lock);
+    struct PNode* old = tree->current;
+    tree->current = root;
+    pthread_mutex_unlock(&tree->lock);
+    pbst_release(old);
+}
+
+// Function to insert a key into the latest version; snapshots taken earlier are unaffected.
+// Writers must be serialised by the caller.
+void pbst_tree_insert(struct PersistentBST* tree, int key) {
+    pbst_publish(tree, pbst_insert(tree->current, key));
+}
+
+// Function to delete a key from the latest version; snapshots taken earlier are unaffected.
+// Writers must be serialised by the caller.
+void pbst_tree_delete(struct PersistentBST* tree, int key) {
+    pbst_publish(tree, pbst_delete(tree->current, key));
+}
+
+// Function to free the published tree; outstanding snapshots stay valid until released
+void pbst_destroy(struct PersistentBST* tree) {
+    pbst_release(tree->current);
+    pthread_mutex_destroy(&tree->lock);
+    free(tree);
+}
+
+#endif
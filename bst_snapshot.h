@@ -0,0 +1,230 @@
+#ifndef BST_SNAPSHOT_H
+#define BST_SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "bst.h"
+
+// Binary snapshot of a BST: a fixed header followed by the keys as a sorted
+// array of native-endian 32-bit ints. A snapshot can be queried in place
+// through mmap, or bulk-built back into a mutable tree.
+
+#define BST_SNAPSHOT_MAGIC "BSTSNAP"
+#define BST_SNAPSHOT_VERSION 1u
+
+struct BSTSnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t key_size;
+    uint64_t count;
+    uint64_t checksum; // FNV-1a over the key array, one 32-bit word at a time
+};
+
+// Streaming writer; keys must be appended in strictly increasing order
+struct BSTSnapshotWriter {
+    FILE* file;
+    uint64_t count;
+    uint64_t checksum;
+    int last;
+};
+
+// Read-only snapshot opened from a file
+struct BSTSnapshot {
+    const int32_t* keys;
+    uint64_t count;
+    void* base;    // Start of the mapping or buffer holding the whole file
+    size_t length;
+    bool mapped;
+};
+
+#define BST_SNAPSHOT_FNV_OFFSET 14695981039346656037ull
+#define BST_SNAPSHOT_FNV_PRIME 1099511628211ull
+
+// Helper to fold one key into a running checksum
+uint64_t bst_snapshot_hash(uint64_t hash, int32_t key) {
+    return (hash ^ (uint32_t)key) * BST_SNAPSHOT_FNV_PRIME;
+}
+
+// Function to start writing a snapshot file; returns false if the file cannot be created
+bool bst_snapshot_writer_open(struct BSTSnapshotWriter* writer, const char* path) {
+    struct BSTSnapshotHeader header;
+
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        return false;
+    }
+    writer->count = 0;
+    writer->checksum = BST_SNAPSHOT_FNV_OFFSET;
+
+    // Placeholder header, rewritten with the final count and checksum on close
+    memset(&header, 0, sizeof(header));
+    if (fwrite(&header, sizeof(header), 1, writer->file) != 1) {
+        fclose(writer->file);
+        writer->file = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Function to append the next key; returns false if it is not larger than the previous key
+bool bst_snapshot_writer_append(struct BSTSnapshotWriter* writer, int key) {
+    if (writer->count > 0 && key <= writer->last) {
+        return false;
+    }
+    int32_t value = key;
+    if (fwrite(&value, sizeof(value), 1, writer->file) != 1) {
+        return false;
+    }
+    writer->checksum = bst_snapshot_hash(writer->checksum, value);
+    writer->last = key;
+    writer->count++;
+    return true;
+}
+
+// Function to finish a snapshot file; returns false on any I/O error
+bool bst_snapshot_writer_close(struct BSTSnapshotWriter* writer) {
+    struct BSTSnapshotHeader header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BST_SNAPSHOT_MAGIC, sizeof(BST_SNAPSHOT_MAGIC));
+    header.version = BST_SNAPSHOT_VERSION;
+    header.key_size = sizeof(int32_t);
+    header.count = writer->count;
+    header.checksum = writer->checksum;
+
+    bool ok = fseek(writer->file, 0, SEEK_SET) == 0 &&
+              fwrite(&header, sizeof(header), 1, writer->file) == 1;
+    ok = fclose(writer->file) == 0 && ok;
+    writer->file = NULL;
+    return ok;
+}
+
+// Helper for bst_snapshot_save: stream each key into the writer
+int bst_snapshot_append_key(int key, void* writer) {
+    return !bst_snapshot_writer_append((struct BSTSnapshotWriter*)writer, key);
+}
+
+// Function to write every key of a tree to a snapshot file
+bool bst_snapshot_save(struct Node* root, const char* path) {
+    struct BSTSnapshotWriter writer;
+    if (!bst_snapshot_writer_open(&writer, path)) {
+        return false;
+    }
+    bool ok = bst_for_each(root, bst_snapshot_append_key, &writer) == size(root) &&
+              writer.count == (uint64_t)size(root);
+    return bst_snapshot_writer_close(&writer) && ok;
+}
+
+// Function to open a snapshot, mapping it when possible and reading it into memory otherwise.
+// Checksum verification reads every key, so it is optional for fast startup.
+bool bst_snapshot_open(struct BSTSnapshot* snapshot, const char* path, bool verify_checksum) {
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct BSTSnapshotHeader)) {
+        close(fd);
+        return false;
+    }
+
+    snapshot->length = (size_t)st.st_size;
+    snapshot->base = mmap(NULL, snapshot->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    snapshot->mapped = snapshot->base != MAP_FAILED;
+    if (!snapshot->mapped) {
+        snapshot->base = malloc(snapshot->length);
+        size_t done = 0;
+        while (snapshot->base != NULL && done < snapshot->length) {
+            ssize_t got = read(fd, (char*)snapshot->base + done, snapshot->length - done);
+            if (got <= 0) {
+                free(snapshot->base);
+                snapshot->base = NULL;
+            } else {
+                done += (size_t)got;
+            }
+        }
+    }
+    close(fd);
+    if (snapshot->base == NULL) {
+        return false;
+    }
+
+    const struct BSTSnapshotHeader* header = (const struct BSTSnapshotHeader*)snapshot->base;
+    snapshot->keys = (const int32_t*)(header + 1);
+    snapshot->count = header->count;
+
+    bool ok = memcmp(header->magic, BST_SNAPSHOT_MAGIC, sizeof(BST_SNAPSHOT_MAGIC)) == 0 &&
+              header->version == BST_SNAPSHOT_VERSION &&
+              header->key_size == sizeof(int32_t) &&
+              header->count == (snapshot->length - sizeof(*header)) / sizeof(int32_t) &&
+              (snapshot->length - sizeof(*header)) % sizeof(int32_t) == 0;
+    if (ok && verify_checksum) {
+        uint64_t hash = BST_SNAPSHOT_FNV_OFFSET;
+        for (uint64_t i = 0; i < snapshot->count; i++) {
+            hash = bst_snapshot_hash(hash, snapshot->keys[i]);
+        }
+        ok = hash == header->checksum;
+    }
+
+    if (!ok) {
+        if (snapshot->mapped) {
+            munmap(snapshot->base, snapshot->length);
+        } else {
+            free(snapshot->base);
+        }
+        snapshot->base = NULL;
+    }
+    return ok;
+}
+
+// Function to find the position of the first key >= key in a snapshot (count if none)
+uint64_t bst_snapshot_lower_bound(const struct BSTSnapshot* snapshot, int key) {
+    const int32_t* base = snapshot->keys;
+    uint64_t n = snapshot->count;
+    if (n == 0) {
+        return 0;
+    }
+    while (n > 1) {
+        uint64_t half = n / 2;
+        base = (base[half] < key) ? base + half : base;
+        n -= half;
+    }
+    return (uint64_t)(base - snapshot->keys) + (*base < key);
+}
+
+// Function to search a snapshot in place without deserialising it
+bool bst_snapshot_search(const struct BSTSnapshot* snapshot, int key) {
+    uint64_t pos = bst_snapshot_lower_bound(snapshot, key);
+    return pos < snapshot->count && snapshot->keys[pos] == key;
+}
+
+// Function to rebuild a mutable, balanced tree from a snapshot in O(n)
+struct Node* bst_snapshot_to_tree(const struct BSTSnapshot* snapshot) {
+    if (snapshot->count > (uint64_t)INT32_MAX) {
+        return NULL;
+    }
+    return build_balanced(snapshot->keys, (int)snapshot->count);
+}
+
+// Function to release a snapshot opened with bst_snapshot_open
+void bst_snapshot_close(struct BSTSnapshot* snapshot) {
+    if (snapshot->base != NULL) {
+        if (snapshot->mapped) {
+            munmap(snapshot->base, snapshot->length);
+        } else {
+            free(snapshot->base);
+        }
+    }
+    snapshot->base = NULL;
+    snapshot->keys = NULL;
+    snapshot->count = 0;
+}
+
+#endif
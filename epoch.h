@@ -0,0 +1,149 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Epoch-based reclamation: memory unlinked by a writer is freed only once every
+// reader that might still hold a pointer to it has left its read-side section.
+
+#define EPOCH_MAX_THREADS 128
+#define EPOCH_IDLE UINT64_MAX
+
+// Number of retired objects to collect before trying to free them
+#define EPOCH_RECLAIM_THRESHOLD 256
+
+// Per-reader announcement, padded to its own cache line
+struct EpochSlot {
+    _Atomic uint64_t epoch;
+    atomic_int in_use;
+    char pad[64 - sizeof(uint64_t) - sizeof(int)];
+};
+
+// Object waiting for all readers of its epoch to finish
+struct EpochRetired {
+    void* ptr;
+    void (*free_fn)(void*);
+    uint64_t epoch;
+    struct EpochRetired* next;
+};
+
+struct EpochDomain {
+    _Atomic uint64_t global;
+    struct EpochSlot slots[EPOCH_MAX_THREADS];
+    pthread_mutex_t retire_lock;
+    struct EpochRetired* retired;
+    size_t retired_count;
+    size_t reclaim_at; // retired_count that triggers the next reclaim pass
+};
+
+// Function to initialise an epoch domain
+void epoch_domain_init(struct EpochDomain* domain) {
+    atomic_init(&domain->global, 0);
+    for (int i = 0; i < EPOCH_MAX_THREADS; ++i) {
+        atomic_init(&domain->slots[i].epoch, EPOCH_IDLE);
+        atomic_init(&domain->slots[i].in_use, 0);
+    }
+    pthread_mutex_init(&domain->retire_lock, NULL);
+    domain->retired = NULL;
+    domain->retired_count = 0;
+    domain->reclaim_at = EPOCH_RECLAIM_THRESHOLD;
+}
+
+// Function to claim a reader slot; each reading thread needs its own
+int epoch_register(struct EpochDomain* domain) {
+    for (int i = 0; i < EPOCH_MAX_THREADS; ++i) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&domain->slots[i].in_use, &expected, 1)) {
+            return i;
+        }
+    }
+    fprintf(stderr, "Too many epoch readers\n");
+    exit(EXIT_FAILURE);
+}
+
+// Function to give a reader slot back
+void epoch_unregister(struct EpochDomain* domain, int slot) {
+    atomic_store(&domain->slots[slot].epoch, EPOCH_IDLE);
+    atomic_store(&domain->slots[slot].in_use, 0);
+}
+
+// Function to start a read-side section; pointers read inside stay valid until epoch_exit
+void epoch_enter(struct EpochDomain* domain, int slot) {
+    atomic_store(&domain->slots[slot].epoch, atomic_load(&domain->global));
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+// Function to end a read-side section
+void epoch_exit(struct EpochDomain* domain, int slot) {
+    atomic_store_explicit(&domain->slots[slot].epoch, EPOCH_IDLE, memory_order_release);
+}
+
+// Helper to free every retired object that no active reader can still see.
+// Caller must hold retire_lock.
+void epoch_reclaim_locked(struct EpochDomain* domain) {
+    atomic_thread_fence(memory_order_seq_cst);
+
+    uint64_t oldest = EPOCH_IDLE;
+    for (int i = 0; i < EPOCH_MAX_THREADS; ++i) {
+        uint64_t epoch = atomic_load(&domain->slots[i].epoch);
+        if (epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    struct EpochRetired** link = &domain->retired;
+    while (*link != NULL) {
+        struct EpochRetired* item = *link;
+        if (item->epoch < oldest) {
+            *link = item->next;
+            item->free_fn(item->ptr);
+            free(item);
+            domain->retired_count--;
+        } else {
+            link = &item->next;
+        }
+    }
+    domain->reclaim_at = domain->retired_count + EPOCH_RECLAIM_THRESHOLD;
+}
+
+// Function to free retired objects that are no longer reachable by any reader
+void epoch_reclaim(struct EpochDomain* domain) {
+    pthread_mutex_lock(&domain->retire_lock);
+    epoch_reclaim_locked(domain);
+    pthread_mutex_unlock(&domain->retire_lock);
+}
+
+// Function to hand over an object that has already been unlinked from the shared structure
+void epoch_retire(struct EpochDomain* domain, void* ptr, void (*free_fn)(void*)) {
+    struct EpochRetired* item = (struct EpochRetired*)malloc(sizeof(struct EpochRetired));
+    item->ptr = ptr;
+    item->free_fn = free_fn;
+
+    pthread_mutex_lock(&domain->retire_lock);
+    // Readers that announce a later epoch started after the unlink and cannot see ptr
+    item->epoch = atomic_fetch_add(&domain->global, 1);
+    item->next = domain->retired;
+    domain->retired = item;
+    if (++domain->retired_count >= domain->reclaim_at) {
+        epoch_reclaim_locked(domain);
+    }
+    pthread_mutex_unlock(&domain->retire_lock);
+}
+
+// Function to free everything still retired; no reader may be active
+void epoch_domain_destroy(struct EpochDomain* domain) {
+    while (domain->retired != NULL) {
+        struct EpochRetired* item = domain->retired;
+        domain->retired = item->next;
+        item->free_fn(item->ptr);
+        free(item);
+    }
+    domain->retired_count = 0;
+    pthread_mutex_destroy(&domain->retire_lock);
+}
+
+#endif
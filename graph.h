@@ -1,18 +1,52 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <limits.h>
+#include <stdatomic.h>
 
 // Structure to represent a node in the adjacency list
 struct Node {
     int data;
+    int weight;
     struct Node* next;
 };
 
+// Open-addressing hash index over one vertex's adjacency list, kept for high-degree vertices.
+// Each neighbour maps to the link that points at its node (the list head or the previous
+// node's next field), so edges can be found and unlinked in O(1) expected time.
+struct EdgeIndex {
+    int capacity;          // Power of two
+    int shift;             // 32 - log2(capacity)
+    int count;
+    int* keys;             // Neighbour per slot, or -1 if the slot is empty
+    struct Node*** links;
+};
+
+// Refcounted owner of adjacency lists shared between graphs. Lists owned by a store are
+// read-only; a graph copies a vertex's list out of the store before changing it.
+struct NodeStore {
+    atomic_int refs;     // Number of (graph, vertex) pairs using a list of this store
+    int vertices;
+    struct Node* block;  // Contiguous nodes of every list, or NULL if the lists were adopted
+    struct Node** heads; // Adopted lists by vertex, freed node by node; NULL with a block
+};
+
 // Structure to represent the graph
 struct Graph {
     int vertices;
     struct Node** adjacencyList;
+    int* inDegrees;              // Number of edges into each vertex
+    int* outDegrees;             // Number of edges out of each vertex
+    struct Node** incomingList;  // Optional reverse adjacency (node data is the source), or NULL
+    struct EdgeIndex** edgeIndex; // Hash index per vertex, or NULL while its out-degree is low
+    int* componentParent;        // Optional union-find forest over the edges (-size at roots), or NULL
+    bool componentsStale;        // Set when a removal may have split a component
+    struct NodeStore** listStore; // Store owning each vertex's list (NULL if private), or NULL if none is shared
+    struct NodeStore** incomingStore; // Same as listStore for the incoming lists
 };
 
 // Structure to represent a queue for BFS
@@ -26,10 +60,20 @@ struct Queue {
 struct Node* createNode(int data) {
     struct Node* newNode = (struct Node*)malloc(sizeof(struct Node));
     newNode->data = data;
+    newNode->weight = 1;
     newNode->next = NULL;
     return newNode;
 }
 
+// Helper to free every node of a list
+void freeList(struct Node* current) {
+    while (current) {
+        struct Node* next = current->next;
+        free(current);
+        current = next;
+    }
+}
+
 // Function to create a graph with a given number of vertices
 struct Graph* createGraph(int vertices) {
     struct Graph* graph = (struct Graph*)malloc(sizeof(struct Graph));
@@ -43,20 +87,327 @@ struct Graph* createGraph(int vertices) {
         graph->adjacencyList[i] = NULL;
     }
 
+    graph->inDegrees = (int*)calloc(vertices, sizeof(int));
+    graph->outDegrees = (int*)calloc(vertices, sizeof(int));
+    graph->incomingList = NULL;
+    graph->edgeIndex = (struct EdgeIndex**)calloc(vertices, sizeof(struct EdgeIndex*));
+    graph->componentParent = NULL;
+    graph->componentsStale = false;
+    graph->listStore = NULL;
+    graph->incomingStore = NULL;
+
     return graph;
 }
 
-// Function to add an edge to an undirected graph
-void addEdge(struct Graph* graph, int src, int dest) {
-    // Add an edge from src to dest
+// Helper to find the root of a vertex in a union-find forest, halving the path on the way
+int findRoot(int* parent, int vertex) {
+    while (parent[vertex] >= 0 && parent[parent[vertex]] >= 0) {
+        parent[vertex] = parent[parent[vertex]];
+        vertex = parent[vertex];
+    }
+    return parent[vertex] >= 0 ? parent[vertex] : vertex;
+}
+
+// Helper to merge the sets of two vertices, hanging the smaller tree under the larger
+void unionRoots(int* parent, int u, int v) {
+    u = findRoot(parent, u);
+    v = findRoot(parent, v);
+    if (u == v) {
+        return;
+    }
+    if (parent[u] > parent[v]) {
+        int tmp = u;
+        u = v;
+        v = tmp;
+    }
+    parent[u] += parent[v];
+    parent[v] = u;
+}
+
+// Helper to rebuild the union-find forest from every edge in O(V + E)
+void rebuildComponents(struct Graph* graph) {
+    for (int i = 0; i < graph->vertices; ++i) {
+        graph->componentParent[i] = -1;
+    }
+    for (int src = 0; src < graph->vertices; ++src) {
+        for (struct Node* current = graph->adjacencyList[src]; current; current = current->next) {
+            unionRoots(graph->componentParent, src, current->data);
+        }
+    }
+    graph->componentsStale = false;
+}
+
+// Function to start tracking connected components (ignoring edge direction) as edges are added,
+// so connected() answers in near-constant time. A removal forces one rebuild on the next query.
+void enableConnectivity(struct Graph* graph) {
+    if (graph->componentParent) {
+        return;
+    }
+    graph->componentParent = (int*)malloc(graph->vertices * sizeof(int));
+    rebuildComponents(graph);
+}
+
+// Function to get a representative vertex of a vertex's component; requires enableConnectivity
+int componentOf(struct Graph* graph, int vertex) {
+    if (graph->componentsStale) {
+        rebuildComponents(graph);
+    }
+    return findRoot(graph->componentParent, vertex);
+}
+
+// Function to check whether two vertices are connected; requires enableConnectivity
+bool connected(struct Graph* graph, int u, int v) {
+    return componentOf(graph, u) == componentOf(graph, v);
+}
+
+// Vertices get an edge index once their out-degree exceeds this, and lose it below a quarter of it
+#define EDGE_INDEX_THRESHOLD 32
+
+// Function to create an empty edge index with the given power-of-two capacity
+struct EdgeIndex* createEdgeIndex(int capacity) {
+    struct EdgeIndex* index = (struct EdgeIndex*)malloc(sizeof(struct EdgeIndex));
+    index->capacity = capacity;
+    index->shift = 32;
+    for (int c = capacity; c > 1; c >>= 1) {
+        index->shift--;
+    }
+    index->count = 0;
+    index->keys = (int*)malloc(capacity * sizeof(int));
+    index->links = (struct Node***)malloc(capacity * sizeof(struct Node**));
+    for (int i = 0; i < capacity; ++i) {
+        index->keys[i] = -1;
+    }
+    return index;
+}
+
+// Function to free an edge index
+void freeEdgeIndex(struct EdgeIndex* index) {
+    if (index) {
+        free(index->keys);
+        free(index->links);
+        free(index);
+    }
+}
+
+// Helper to get the home slot of a neighbour (Fibonacci hashing)
+int edgeIndexHome(struct EdgeIndex* index, int key) {
+    return (int)(((unsigned)key * 2654435769u) >> index->shift);
+}
+
+// Function to find the slot holding a neighbour, or -1 if absent
+int edgeIndexFind(struct EdgeIndex* index, int key) {
+    for (int i = edgeIndexHome(index, key);; i = (i + 1) & (index->capacity - 1)) {
+        if (index->keys[i] == key) {
+            return i;
+        }
+        if (index->keys[i] == -1) {
+            return -1;
+        }
+    }
+}
+
+// Function to set the link of a neighbour, inserting it if absent; grows at half full
+void edgeIndexPut(struct EdgeIndex* index, int key, struct Node** link) {
+    int slot = edgeIndexFind(index, key);
+    if (slot >= 0) {
+        index->links[slot] = link;
+        return;
+    }
+
+    if (2 * (index->count + 1) > index->capacity) {
+        struct EdgeIndex* bigger = createEdgeIndex(2 * index->capacity);
+        for (int i = 0; i < index->capacity; ++i) {
+            if (index->keys[i] != -1) {
+                edgeIndexPut(bigger, index->keys[i], index->links[i]);
+            }
+        }
+        free(index->keys);
+        free(index->links);
+        *index = *bigger;
+        free(bigger);
+    }
+
+    slot = edgeIndexHome(index, key);
+    while (index->keys[slot] != -1) {
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    index->keys[slot] = key;
+    index->links[slot] = link;
+    index->count++;
+}
+
+// Function to remove a neighbour, shifting later entries of its probe run back into the gap
+void edgeIndexRemove(struct EdgeIndex* index, int key) {
+    int mask = index->capacity - 1;
+    int hole = edgeIndexFind(index, key);
+    if (hole < 0) {
+        return;
+    }
+
+    for (int i = (hole + 1) & mask; index->keys[i] != -1; i = (i + 1) & mask) {
+        int home = edgeIndexHome(index, index->keys[i]);
+        // Move the entry unless its home lies cyclically in (hole, i]
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            index->keys[hole] = index->keys[i];
+            index->links[hole] = index->links[i];
+            hole = i;
+        }
+    }
+    index->keys[hole] = -1;
+    index->count--;
+}
+
+// Function to build the edge index of a vertex from its adjacency list
+struct EdgeIndex* buildEdgeIndex(struct Graph* graph, int vertex) {
+    int capacity = 4 * EDGE_INDEX_THRESHOLD;
+    while (capacity < 2 * graph->outDegrees[vertex]) {
+        capacity *= 2;
+    }
+
+    struct EdgeIndex* index = createEdgeIndex(capacity);
+    for (struct Node** link = &graph->adjacencyList[vertex]; *link; link = &(*link)->next) {
+        edgeIndexPut(index, (*link)->data, link);
+    }
+    return index;
+}
+
+// Function to find the node of the edge from src to dest, or NULL if there is none
+struct Node* findEdge(struct Graph* graph, int src, int dest) {
+    struct EdgeIndex* index = graph->edgeIndex[src];
+    if (index) {
+        int slot = edgeIndexFind(index, dest);
+        return slot >= 0 ? *index->links[slot] : NULL;
+    }
+
+    struct Node* current = graph->adjacencyList[src];
+    while (current && current->data != dest) {
+        current = current->next;
+    }
+    return current;
+}
+
+// Function to create a store for the lists of a graph with the given number of vertices
+struct NodeStore* createNodeStore(int vertices, struct Node* block) {
+    struct NodeStore* store = (struct NodeStore*)malloc(sizeof(struct NodeStore));
+    atomic_init(&store->refs, 0);
+    store->vertices = vertices;
+    store->block = block;
+    store->heads = block ? NULL : (struct Node**)calloc(vertices, sizeof(struct Node*));
+    return store;
+}
+
+// Function to drop one reference to a store, freeing its lists after the last
+void releaseNodeStore(struct NodeStore* store) {
+    if (atomic_fetch_sub_explicit(&store->refs, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+    if (store->block) {
+        free(store->block);
+    } else {
+        for (int i = 0; i < store->vertices; ++i) {
+            freeList(store->heads[i]);
+        }
+        free(store->heads);
+    }
+    free(store);
+}
+
+// Helper to copy a list out of its store into private nodes, dropping the store reference
+struct Node* copyStoredList(struct Node* list, struct NodeStore** store) {
+    struct Node* head = NULL;
+    struct Node** tail = &head;
+    for (struct Node* current = list; current; current = current->next) {
+        *tail = createNode(current->data);
+        (*tail)->weight = current->weight;
+        tail = &(*tail)->next;
+    }
+    releaseNodeStore(*store);
+    *store = NULL;
+    return head;
+}
+
+// Helper to make a vertex's incoming list private before it is changed
+void ownIncoming(struct Graph* graph, int vertex) {
+    if (graph->incomingStore && graph->incomingStore[vertex]) {
+        graph->incomingList[vertex] = copyStoredList(graph->incomingList[vertex], &graph->incomingStore[vertex]);
+    }
+}
+
+// Helper to make a vertex's list private before it is changed, copying it out of its store
+void ownAdjacency(struct Graph* graph, int vertex) {
+    if (!graph->listStore || !graph->listStore[vertex]) {
+        return;
+    }
+
+    graph->adjacencyList[vertex] = copyStoredList(graph->adjacencyList[vertex], &graph->listStore[vertex]);
+
+    // The old index links point into the store's nodes
+    if (graph->edgeIndex[vertex]) {
+        freeEdgeIndex(graph->edgeIndex[vertex]);
+        graph->edgeIndex[vertex] = buildEdgeIndex(graph, vertex);
+    }
+}
+
+// Helper to add a single edge from src to dest, keeping degrees, the edge index and the reverse
+// adjacency current; returns false, changing nothing, if the edge already exists
+bool addArc(struct Graph* graph, int src, int dest, int weight) {
+    if (findEdge(graph, src, dest)) {
+        return false;
+    }
+    ownAdjacency(graph, src);
+
     struct Node* newNode = createNode(dest);
+    newNode->weight = weight;
     newNode->next = graph->adjacencyList[src];
     graph->adjacencyList[src] = newNode;
 
+    struct EdgeIndex* index = graph->edgeIndex[src];
+    if (index) {
+        // The old head is now linked from the new node
+        if (newNode->next) {
+            edgeIndexPut(index, newNode->next->data, &newNode->next);
+        }
+        edgeIndexPut(index, dest, &graph->adjacencyList[src]);
+    }
+
+    graph->outDegrees[src]++;
+    graph->inDegrees[dest]++;
+    if (graph->incomingList) {
+        ownIncoming(graph, dest);
+        newNode = createNode(src);
+        newNode->weight = weight;
+        newNode->next = graph->incomingList[dest];
+        graph->incomingList[dest] = newNode;
+    }
+
+    if (graph->componentParent && !graph->componentsStale) {
+        unionRoots(graph->componentParent, src, dest);
+    }
+
+    if (!index && graph->outDegrees[src] > EDGE_INDEX_THRESHOLD) {
+        graph->edgeIndex[src] = buildEdgeIndex(graph, src);
+    }
+    return true;
+}
+
+// Function to add a weighted edge to an undirected graph; returns false if it already existed,
+// in which case its weight is left unchanged
+bool addWeightedEdge(struct Graph* graph, int src, int dest, int weight) {
+    bool added = addArc(graph, src, dest, weight);
+
     // Since the graph is undirected, add an edge from dest to src as well
-    newNode = createNode(src);
-    newNode->next = graph->adjacencyList[dest];
-    graph->adjacencyList[dest] = newNode;
+    addArc(graph, dest, src, weight);
+    return added;
+}
+
+// Function to add an edge to an undirected graph; returns false if it already existed
+bool addEdge(struct Graph* graph, int src, int dest) {
+    return addWeightedEdge(graph, src, dest, 1);
+}
+
+// Function to add a weighted edge from src to dest only; returns false if it already existed
+bool addDirectedEdge(struct Graph* graph, int src, int dest, int weight) {
+    return addArc(graph, src, dest, weight);
 }
 
 void printGraph(struct Graph* graph) {
@@ -159,20 +510,85 @@ void bfs(struct Graph* graph, int startVertex) {
     free(queue);
 }
 
-// Recursive function for Depth-First Search (DFS)
-void dfsUtil(struct Graph* graph, int vertex, bool* visited) {
+// Frame of an explicit DFS stack: a vertex and the next adjacency node to look at
+struct DfsFrame {
+    int vertex;
+    struct Node* next;
+};
+
+// Growable DFS stack, so deep graphs do not overflow the thread stack
+struct DfsStack {
+    int top, capacity;
+    struct DfsFrame* frames;
+};
+
+// Function to create an empty DFS stack
+void initDfsStack(struct DfsStack* stack) {
+    stack->top = 0;
+    stack->capacity = 64;
+    stack->frames = (struct DfsFrame*)malloc(stack->capacity * sizeof(struct DfsFrame));
+}
+
+// Function to push a vertex with its adjacency list as the neighbour cursor
+void pushDfsFrame(struct DfsStack* stack, struct Graph* graph, int vertex) {
+    if (stack->top == stack->capacity) {
+        stack->capacity *= 2;
+        stack->frames = (struct DfsFrame*)realloc(stack->frames, stack->capacity * sizeof(struct DfsFrame));
+    }
+    stack->frames[stack->top].vertex = vertex;
+    stack->frames[stack->top].next = graph->adjacencyList[vertex];
+    stack->top++;
+}
+
+// Function to write the vertices reached from vertex into order, in DFS preorder; returns how many.
+// Vertices already marked in visited are skipped.
+int dfsVisit(struct Graph* graph, int vertex, bool* visited, int* order) {
+    struct DfsStack stack;
+    int count = 0;
+
+    initDfsStack(&stack);
     visited[vertex] = true;
-    printf("%d ", vertex);
+    order[count++] = vertex;
+    pushDfsFrame(&stack, graph, vertex);
+
+    while (stack.top > 0) {
+        struct DfsFrame* frame = &stack.frames[stack.top - 1];
+        if (frame->next == NULL) {
+            stack.top--;
+            continue;
+        }
 
-    // Visit all adjacent vertices of the current vertex
-    struct Node* temp = graph->adjacencyList[vertex];
-    while (temp) {
-        int adjVertex = temp->data;
+        // Advance the cursor before pushing, which may move the frames
+        int adjVertex = frame->next->data;
+        frame->next = frame->next->next;
         if (!visited[adjVertex]) {
-            dfsUtil(graph, adjVertex, visited);
+            visited[adjVertex] = true;
+            order[count++] = adjVertex;
+            pushDfsFrame(&stack, graph, adjVertex);
         }
-        temp = temp->next;
     }
+
+    free(stack.frames);
+    return count;
+}
+
+// Function for Depth-First Search (DFS) from a vertex, printing each newly visited vertex
+void dfsUtil(struct Graph* graph, int vertex, bool* visited) {
+    int* order = (int*)malloc(graph->vertices * sizeof(int));
+    int count = dfsVisit(graph, vertex, visited, order);
+
+    for (int i = 0; i < count; ++i) {
+        printf("%d ", order[i]);
+    }
+    free(order);
+}
+
+// Function to write the DFS order from startVertex into order; returns the number of vertices reached
+int dfsOrder(struct Graph* graph, int startVertex, int* order) {
+    bool* visited = (bool*)calloc(graph->vertices, sizeof(bool));
+    int count = dfsVisit(graph, startVertex, visited, order);
+    free(visited);
+    return count;
 }
 
 // Function to perform Depth-First Search (DFS)
@@ -197,170 +613,275 @@ void dfs(struct Graph* graph, int startVertex) {
 // Function to free the memory allocated for the graph
 void freeGraph(struct Graph* graph) {
     for (int i = 0; i < graph->vertices; ++i) {
-        struct Node* current = graph->adjacencyList[i];
-        while (current) {
-            struct Node* next = current->next;
-            free(current);
-            current = next;
+        if (graph->listStore && graph->listStore[i]) {
+            releaseNodeStore(graph->listStore[i]);
+        } else {
+            freeList(graph->adjacencyList[i]);
+        }
+        if (graph->incomingStore && graph->incomingStore[i]) {
+            releaseNodeStore(graph->incomingStore[i]);
+        } else if (graph->incomingList) {
+            freeList(graph->incomingList[i]);
         }
+        freeEdgeIndex(graph->edgeIndex[i]);
     }
     free(graph->adjacencyList);
+    free(graph->edgeIndex);
+    free(graph->componentParent);
+    free(graph->listStore);
+    free(graph->incomingStore);
+    free(graph->incomingList);
+    free(graph->inDegrees);
+    free(graph->outDegrees);
     free(graph);
 }
 
-// Function to check if an edge exists between two vertices
-bool hasEdge(struct Graph* graph, int src, int dest) {
-    struct Node* current = graph->adjacencyList[src];
-    while (current) {
-        if (current->data == dest) {
-            return true;
+// Function to start maintaining the reverse adjacency, so the sources of the edges into a
+// vertex can be listed in O(in-degree); built once in O(V + E), then kept current by every update
+void enableReverseAdjacency(struct Graph* graph) {
+    if (graph->incomingList) {
+        return;
+    }
+    graph->incomingList = (struct Node**)calloc(graph->vertices, sizeof(struct Node*));
+    for (int src = 0; src < graph->vertices; ++src) {
+        for (struct Node* current = graph->adjacencyList[src]; current; current = current->next) {
+            struct Node* newNode = createNode(src);
+            newNode->weight = current->weight;
+            newNode->next = graph->incomingList[current->data];
+            graph->incomingList[current->data] = newNode;
         }
-        current = current->next;
     }
-    return false;
 }
 
-// Function to remove an edge between two vertices
-void removeEdge(struct Graph* graph, int src, int dest) {
-    struct Node* current = graph->adjacencyList[src];
+// Function to get the list of edges into a vertex (node data is the source); requires
+// enableReverseAdjacency
+struct Node* incomingEdges(struct Graph* graph, int vertex) {
+    return graph->incomingList ? graph->incomingList[vertex] : NULL;
+}
+
+// Function to check if an edge exists between two vertices
+bool hasEdge(struct Graph* graph, int src, int dest) {
+    return findEdge(graph, src, dest) != NULL;
+}
+
+// Helper to unlink and free the first node holding data from a list; returns false if absent
+bool unlinkNode(struct Node** head, int data) {
+    struct Node* current = *head;
     struct Node* prev = NULL;
 
-    // Find and remove the edge in the adjacency list of src
     while (current) {
-        if (current->data == dest) {
+        if (current->data == data) {
             if (prev) {
                 prev->next = current->next;
             } else {
-                graph->adjacencyList[src] = current->next;
+                *head = current->next;
             }
             free(current);
-            break;
+            return true;
         }
         prev = current;
         current = current->next;
     }
+    return false;
+}
 
-    // Remove the reverse edge for an undirected graph
-    current = graph->adjacencyList[dest];
-    prev = NULL;
+// Helper to remove a single edge from src to dest, keeping degrees and the reverse adjacency current
+void removeArc(struct Graph* graph, int src, int dest) {
+    if (graph->listStore && graph->listStore[src]) {
+        if (!findEdge(graph, src, dest)) {
+            return;
+        }
+        ownAdjacency(graph, src);
+    }
 
-    while (current) {
-        if (current->data == src) {
-            if (prev) {
-                prev->next = current->next;
-            } else {
-                graph->adjacencyList[dest] = current->next;
+    struct EdgeIndex* index = graph->edgeIndex[src];
+    bool removed;
+
+    if (index) {
+        int slot = edgeIndexFind(index, dest);
+        removed = slot >= 0;
+        if (removed) {
+            // Unlink through the stored link; the next node inherits it
+            struct Node** link = index->links[slot];
+            struct Node* node = *link;
+            *link = node->next;
+            if (node->next) {
+                edgeIndexPut(index, node->next->data, link);
             }
-            free(current);
-            break;
+            edgeIndexRemove(index, dest);
+            free(node);
         }
-        prev = current;
-        current = current->next;
+    } else {
+        removed = unlinkNode(&graph->adjacencyList[src], dest);
     }
-}
-
-// Function to get the in-degree of a vertex
-int inDegree(struct Graph* graph, int vertex) {
-    int inDegreeCount = 0;
 
-    for (int i = 0; i < graph->vertices; ++i) {
-        struct Node* current = graph->adjacencyList[i];
-        while (current) {
-            if (current->data == vertex) {
-                inDegreeCount++;
-                break;
-            }
-            current = current->next;
+    if (removed) {
+        graph->outDegrees[src]--;
+        graph->inDegrees[dest]--;
+        if (graph->incomingList) {
+            ownIncoming(graph, dest);
+            unlinkNode(&graph->incomingList[dest], src);
+        }
+        if (graph->componentParent) {
+            graph->componentsStale = true;
+        }
+        if (index && graph->outDegrees[src] < EDGE_INDEX_THRESHOLD / 4) {
+            freeEdgeIndex(index);
+            graph->edgeIndex[src] = NULL;
         }
     }
+}
 
-    return inDegreeCount;
+// Function to remove an edge between two vertices
+void removeEdge(struct Graph* graph, int src, int dest) {
+    removeArc(graph, src, dest);
+
+    // Remove the reverse edge for an undirected graph
+    removeArc(graph, dest, src);
 }
 
-// Function to get the out-degree of a vertex
-int outDegree(struct Graph* graph, int vertex) {
-    int outDegreeCount = 0;
+// Function to remove the edge from src to dest only
+void removeDirectedEdge(struct Graph* graph, int src, int dest) {
+    removeArc(graph, src, dest);
+}
 
-    struct Node* current = graph->adjacencyList[vertex];
-    while (current) {
-        outDegreeCount++;
-        current = current->next;
-    }
+// Function to get the in-degree of a vertex in O(1)
+int inDegree(struct Graph* graph, int vertex) {
+    return graph->inDegrees[vertex];
+}
 
-    return outDegreeCount;
+// Function to get the out-degree of a vertex in O(1)
+int outDegree(struct Graph* graph, int vertex) {
+    return graph->outDegrees[vertex];
 }
 
-// Helper function for topological sort
+// Helper function for topological sort: places every vertex reachable from vertex in front of
+// its descendants, filling stack from *index downwards
 void topologicalSortUtil(struct Graph* graph, int vertex, bool* visited, int* stack, int* index) {
+    struct DfsStack dfsStack;
+
+    initDfsStack(&dfsStack);
     visited[vertex] = true;
+    pushDfsFrame(&dfsStack, graph, vertex);
+
+    while (dfsStack.top > 0) {
+        struct DfsFrame* frame = &dfsStack.frames[dfsStack.top - 1];
+        if (frame->next == NULL) {
+            // All descendants are placed, so this vertex goes in front of them
+            stack[(*index)--] = frame->vertex;
+            dfsStack.top--;
+            continue;
+        }
 
-    struct Node* current = graph->adjacencyList[vertex];
-    while (current) {
-        int adjVertex = current->data;
+        int adjVertex = frame->next->data;
+        frame->next = frame->next->next;
         if (!visited[adjVertex]) {
-            topologicalSortUtil(graph, adjVertex, visited, stack, index);
+            visited[adjVertex] = true;
+            pushDfsFrame(&dfsStack, graph, adjVertex);
         }
-        current = current->next;
     }
 
-    stack[(*index)--] = vertex;
+    free(dfsStack.frames);
 }
 
-// Function to perform topological sort
-void topologicalSort(struct Graph* graph) {
-    bool* visited = (bool*)malloc(graph->vertices * sizeof(bool));
-    for (int i = 0; i < graph->vertices; ++i) {
-        visited[i] = false;
-    }
-
-    int* stack = (int*)malloc(graph->vertices * sizeof(int));
+// Function to write a topological order of a directed acyclic graph into result
+void topologicalOrder(struct Graph* graph, int* result) {
+    bool* visited = (bool*)calloc(graph->vertices, sizeof(bool));
     int index = graph->vertices - 1;
 
     for (int i = 0; i < graph->vertices; ++i) {
         if (!visited[i]) {
-            topologicalSortUtil(graph, i, visited, stack, &index);
+            topologicalSortUtil(graph, i, visited, result, &index);
         }
     }
 
+    free(visited);
+}
+
+// Function to perform topological sort
+void topologicalSort(struct Graph* graph) {
+    int* stack = (int*)malloc(graph->vertices * sizeof(int));
+    topologicalOrder(graph, stack);
+
     printf("Topological Sort: ");
     for (int i = 0; i < graph->vertices; ++i) {
         printf("%d ", stack[i]);
     }
     printf("\n");
 
-    free(visited);
     free(stack);
 }
 
-// Helper function for cycle detection in DFS
-bool isCyclicUtil(struct Graph* graph, int vertex, bool* visited, bool* inStack) {
+// Helper function for cycle detection: DFS from vertex, skipping vertices already visited.
+// Returns the length of the first cycle found (0 if none) and, unless cycle is NULL, writes
+// its vertices there in edge order.
+int findCycleFrom(struct Graph* graph, int vertex, bool* visited, bool* inStack, int* cycle) {
+    struct DfsStack stack;
+    int length = 0;
+
+    initDfsStack(&stack);
     visited[vertex] = true;
     inStack[vertex] = true;
+    pushDfsFrame(&stack, graph, vertex);
+
+    while (stack.top > 0 && length == 0) {
+        struct DfsFrame* frame = &stack.frames[stack.top - 1];
+        if (frame->next == NULL) {
+            // Remove the vertex from the DFS path after exploration
+            inStack[frame->vertex] = false;
+            stack.top--;
+            continue;
+        }
 
-    struct Node* current = graph->adjacencyList[vertex];
-    while (current) {
-        int adjVertex = current->data;
+        int adjVertex = frame->next->data;
+        frame->next = frame->next->next;
         if (!visited[adjVertex]) {
-            if (isCyclicUtil(graph, adjVertex, visited, inStack)) {
-                return true;
-            }
+            visited[adjVertex] = true;
+            inStack[adjVertex] = true;
+            pushDfsFrame(&stack, graph, adjVertex);
         } else if (inStack[adjVertex]) {
-            // If the adjacent vertex is already in the stack, then there is a cycle
-            return true;
+            // The adjacent vertex is on the current path: the path from it to here is a cycle
+            int start = stack.top - 1;
+            while (stack.frames[start].vertex != adjVertex) {
+                start--;
+            }
+            length = stack.top - start;
+            for (int i = start; cycle != NULL && i < stack.top; ++i) {
+                cycle[i - start] = stack.frames[i].vertex;
+            }
         }
-
-        current = current->next;
     }
 
-    // Remove the vertex from the recursion stack after exploration
-    inStack[vertex] = false;
+    free(stack.frames);
+    return length;
+}
 
-    return false;
+// Helper function for cycle detection in DFS
+bool isCyclicUtil(struct Graph* graph, int vertex, bool* visited, bool* inStack) {
+    return findCycleFrom(graph, vertex, visited, inStack, NULL) > 0;
+}
+
+// Function to find a cycle in a directed graph; writes its vertices into cycle (room for all
+// vertices) in edge order and returns how many, or returns 0 if the graph is acyclic
+int findCycle(struct Graph* graph, int* cycle) {
+    bool* visited = (bool*)calloc(graph->vertices, sizeof(bool));
+    bool* inStack = (bool*)calloc(graph->vertices, sizeof(bool));
+    int length = 0;
+
+    for (int i = 0; i < graph->vertices && length == 0; ++i) {
+        if (!visited[i]) {
+            length = findCycleFrom(graph, i, visited, inStack, cycle);
+        }
+    }
+
+    free(visited);
+    free(inStack);
+    return length;
 }
 
 // Function to detect cycles in a directed graph
 bool hasCycle(struct Graph* graph) {
-    // Create arrays to keep track of visited vertices and the recursion stack
+    // Create arrays to keep track of visited vertices and the current DFS path
     bool* visited = (bool*)malloc(graph->vertices * sizeof(bool));
     bool* inStack = (bool*)malloc(graph->vertices * sizeof(bool));
 
@@ -389,9 +910,9 @@ bool hasCycle(struct Graph* graph) {
     return false;
 }
 
-// Function to find the vertex with the minimum distance value
+// Function to find the vertex with the minimum distance value; returns -1 if none is reachable
 int minDistance(int* distance, bool* sptSet, int vertices) {
-    int min = INT_MAX, minIndex;
+    int min = INT_MAX, minIndex = -1;
 
     for (int v = 0; v < vertices; ++v) {
         if (!sptSet[v] && distance[v] < min) {
@@ -412,100 +933,299 @@ void printDijkstra(int* distance, int vertices, int startVertex) {
     }
 }
 
-// Function to perform Dijkstra's algorithm
-void dijkstra(struct Graph* graph, int startVertex) {
+// Indexed min-heap of vertices keyed by distance, with decrease-key
+#define HEAP_ARITY 4
+
+struct IndexedHeap {
+    int size;
+    int* vertices;   // Heap order
+    int* position;   // Index of each vertex in vertices, or -1 if not queued
+    const int* key;  // Distance array the heap is ordered by
+};
+
+// Function to create an empty heap over the given number of vertices
+struct IndexedHeap* createIndexedHeap(int vertices, const int* key) {
+    struct IndexedHeap* heap = (struct IndexedHeap*)malloc(sizeof(struct IndexedHeap));
+    heap->size = 0;
+    heap->vertices = (int*)malloc(vertices * sizeof(int));
+    heap->position = (int*)malloc(vertices * sizeof(int));
+    heap->key = key;
+    for (int i = 0; i < vertices; ++i) {
+        heap->position[i] = -1;
+    }
+    return heap;
+}
+
+// Function to free a heap
+void freeIndexedHeap(struct IndexedHeap* heap) {
+    free(heap->vertices);
+    free(heap->position);
+    free(heap);
+}
+
+// Helper to move the vertex at index i up until its parent is not larger
+void heapSiftUp(struct IndexedHeap* heap, int i) {
+    int vertex = heap->vertices[i];
+    int key = heap->key[vertex];
+
+    while (i > 0) {
+        int parent = (i - 1) / HEAP_ARITY;
+        if (heap->key[heap->vertices[parent]] <= key) {
+            break;
+        }
+        heap->vertices[i] = heap->vertices[parent];
+        heap->position[heap->vertices[i]] = i;
+        i = parent;
+    }
+    heap->vertices[i] = vertex;
+    heap->position[vertex] = i;
+}
+
+// Helper to move the vertex at index i down until no child is smaller
+void heapSiftDown(struct IndexedHeap* heap, int i) {
+    int vertex = heap->vertices[i];
+    int key = heap->key[vertex];
+
+    for (;;) {
+        int first = i * HEAP_ARITY + 1;
+        if (first >= heap->size) {
+            break;
+        }
+        int last = first + HEAP_ARITY < heap->size ? first + HEAP_ARITY : heap->size;
+        int best = first;
+        for (int c = first + 1; c < last; ++c) {
+            if (heap->key[heap->vertices[c]] < heap->key[heap->vertices[best]]) {
+                best = c;
+            }
+        }
+        if (heap->key[heap->vertices[best]] >= key) {
+            break;
+        }
+        heap->vertices[i] = heap->vertices[best];
+        heap->position[heap->vertices[i]] = i;
+        i = best;
+    }
+    heap->vertices[i] = vertex;
+    heap->position[vertex] = i;
+}
+
+// Function to queue a vertex, or move it up after its key has decreased
+void heapPushOrDecrease(struct IndexedHeap* heap, int vertex) {
+    int i = heap->position[vertex];
+    if (i < 0) {
+        i = heap->size++;
+        heap->vertices[i] = vertex;
+    }
+    heapSiftUp(heap, i);
+}
+
+// Function to remove and return the vertex with the smallest key
+int heapPopMin(struct IndexedHeap* heap) {
+    int top = heap->vertices[0];
+    heap->position[top] = -1;
+    if (--heap->size > 0) {
+        heap->vertices[0] = heap->vertices[heap->size];
+        heapSiftDown(heap, 0);
+    }
+    return top;
+}
+
+// Function to compute shortest paths from startVertex using the edge weights, which must be
+// non-negative. Fills distance (INT_MAX if unreachable) and predecessor (-1 for the start and
+// unreachable vertices). If target is not -1 the search stops once target is settled, and only
+// distances of vertices settled up to that point are final.
+void shortestPaths(struct Graph* graph, int startVertex, int target, int* distance, int* predecessor) {
     int vertices = graph->vertices;
-    int* distance = (int*)malloc(vertices * sizeof(int));
-    bool* sptSet = (bool*)malloc(vertices * sizeof(bool));
+    struct IndexedHeap* heap = createIndexedHeap(vertices, distance);
 
-    // Initialize distances and set of visited vertices
     for (int i = 0; i < vertices; ++i) {
         distance[i] = INT_MAX;
-        sptSet[i] = false;
+        predecessor[i] = -1;
     }
-
-    // Distance from the source vertex to itself is always 0
     distance[startVertex] = 0;
+    heapPushOrDecrease(heap, startVertex);
 
-    // Find shortest path for all vertices
-    for (int count = 0; count < vertices - 1; ++count) {
-        int u = minDistance(distance, sptSet, vertices);
-
-        // Mark the selected vertex as visited
-        sptSet[u] = true;
+    while (heap->size > 0) {
+        int u = heapPopMin(heap);
+        if (u == target) {
+            break;
+        }
 
-        // Update distance value of the adjacent vertices
         struct Node* current = graph->adjacencyList[u];
         while (current) {
             int v = current->data;
-            if (!sptSet[v] && distance[u] != INT_MAX &&
-                distance[u] + 1 < distance[v]) {  // Assuming edge weights are 1
-                distance[v] = distance[u] + 1;
+            // Skip edges whose distance would overflow
+            if (current->weight <= INT_MAX - distance[u] &&
+                distance[u] + current->weight < distance[v]) {
+                distance[v] = distance[u] + current->weight;
+                predecessor[v] = u;
+                heapPushOrDecrease(heap, v);
             }
             current = current->next;
         }
     }
 
+    freeIndexedHeap(heap);
+}
+
+// Function to write the path from the start vertex to target into path using the predecessor
+// array from shortestPaths; returns the number of vertices on it (0 if target is unreachable)
+int shortestPathTo(int* distance, int* predecessor, int target, int* path) {
+    if (distance[target] == INT_MAX) {
+        return 0;
+    }
+
+    int length = 0;
+    for (int v = target; v != -1; v = predecessor[v]) {
+        path[length++] = v;
+    }
+    for (int i = 0, j = length - 1; i < j; ++i, --j) {
+        int tmp = path[i];
+        path[i] = path[j];
+        path[j] = tmp;
+    }
+    return length;
+}
+
+// Function to perform Dijkstra's algorithm
+void dijkstra(struct Graph* graph, int startVertex) {
+    int vertices = graph->vertices;
+    int* distance = (int*)malloc(vertices * sizeof(int));
+    int* predecessor = (int*)malloc(vertices * sizeof(int));
+
+    shortestPaths(graph, startVertex, -1, distance, predecessor);
+
     // Print the solution
     printDijkstra(distance, vertices, startVertex);
 
     // Free allocated memory
     free(distance);
-    free(sptSet);
+    free(predecessor);
 }
 
-// Helper function to clone a graph using DFS
-void cloneGraphUtil(struct Graph* original, struct Graph* cloned, int vertex, bool* visited, int* vertexMap) {
-    visited[vertex] = true;
-
-    // Create a mapping from original vertex to cloned vertex
-    vertexMap[vertex] = cloned->vertices;
+// Helper to give a clone the degree counters, edge indexes and optional structures of the original
+void cloneGraphExtras(struct Graph* original, struct Graph* cloned) {
+    memcpy(cloned->inDegrees, original->inDegrees, original->vertices * sizeof(int));
+    memcpy(cloned->outDegrees, original->outDegrees, original->vertices * sizeof(int));
 
-    // Add vertices to the cloned graph
     for (int i = 0; i < original->vertices; ++i) {
-        if (!visited[i]) {
-            struct Node* current = original->adjacencyList[i];
-            while (current) {
-                addEdge(cloned, vertexMap[i], vertexMap[current->data]);
-                current = current->next;
-            }
+        struct EdgeIndex* index = original->edgeIndex[i];
+        if (index == NULL) {
+            continue;
+        }
+        if (!original->listStore || cloned->listStore[i] != original->listStore[i]) {
+            cloned->edgeIndex[i] = buildEdgeIndex(cloned, i);
+            continue;
         }
+
+        // Shared list: every link except the head's points into shared nodes and stays valid
+        struct EdgeIndex* copy = createEdgeIndex(index->capacity);
+        memcpy(copy->keys, index->keys, index->capacity * sizeof(int));
+        memcpy(copy->links, index->links, index->capacity * sizeof(struct Node**));
+        copy->count = index->count;
+        copy->links[edgeIndexFind(copy, cloned->adjacencyList[i]->data)] = &cloned->adjacencyList[i];
+        cloned->edgeIndex[i] = copy;
     }
 
-    // Recursively clone the neighbors of the current vertex
-    struct Node* current = original->adjacencyList[vertex];
-    while (current) {
-        if (!visited[current->data]) {
-            cloneGraphUtil(original, cloned, current->data, visited, vertexMap);
-        }
-        current = current->next;
+    if (original->incomingList) {
+        enableReverseAdjacency(cloned);
+    }
+    if (original->componentParent) {
+        cloned->componentParent = (int*)malloc(original->vertices * sizeof(int));
+        memcpy(cloned->componentParent, original->componentParent, original->vertices * sizeof(int));
+        cloned->componentsStale = original->componentsStale;
     }
 }
 
-// Function to clone a graph
+// Function to clone a graph in O(V + E), keeping the order of every adjacency list. All nodes of
+// the clone sit in one contiguous block; the first change to a vertex moves its list out of it.
 struct Graph* cloneGraph(struct Graph* original) {
     if (!original) {
         return NULL;
     }
 
-    // Create a new graph with the same number of vertices
     struct Graph* cloned = createGraph(original->vertices);
+    long edges = 0;
+    for (int i = 0; i < original->vertices; ++i) {
+        edges += original->outDegrees[i];
+    }
 
-    // Array to keep track of visited vertices during DFS
-    bool* visited = (bool*)malloc(original->vertices * sizeof(bool));
-    int* vertexMap = (int*)malloc(original->vertices * sizeof(int));
+    cloned->listStore = (struct NodeStore**)calloc(original->vertices, sizeof(struct NodeStore*));
+    if (edges > 0) {
+        struct Node* block = (struct Node*)malloc(edges * sizeof(struct Node));
+        struct NodeStore* store = createNodeStore(original->vertices, block);
+        int users = 0;
+
+        for (int i = 0; i < original->vertices; ++i) {
+            struct Node** tail = &cloned->adjacencyList[i];
+            for (struct Node* current = original->adjacencyList[i]; current; current = current->next) {
+                *block = *current;
+                *tail = block;
+                tail = &block->next;
+                block++;
+            }
+            *tail = NULL;
+            if (cloned->adjacencyList[i]) {
+                cloned->listStore[i] = store;
+                users++;
+            }
+        }
+        atomic_store(&store->refs, users);
+    }
 
-    // Initialize visited array
-    for (int i = 0; i < original->vertices; ++i) {
-        visited[i] = false;
+    cloneGraphExtras(original, cloned);
+    return cloned;
+}
+
+// Helper to share every list of an original with a clone. Private lists of the original move into
+// a new store both graphs reference; *stores is allocated on first use.
+void shareLists(int vertices, struct Node** lists, struct NodeStore*** stores,
+                struct Node** clonedLists, struct NodeStore** clonedStores) {
+    struct NodeStore* adopted = NULL;
+
+    if (!*stores) {
+        *stores = (struct NodeStore**)calloc(vertices, sizeof(struct NodeStore*));
+    }
+    for (int i = 0; i < vertices; ++i) {
+        if (!lists[i]) {
+            continue;
+        }
+        if (!(*stores)[i]) {
+            if (!adopted) {
+                adopted = createNodeStore(vertices, NULL);
+            }
+            adopted->heads[i] = lists[i];
+            (*stores)[i] = adopted;
+            atomic_fetch_add_explicit(&adopted->refs, 1, memory_order_relaxed);
+        }
+        clonedLists[i] = lists[i];
+        clonedStores[i] = (*stores)[i];
+        atomic_fetch_add_explicit(&clonedStores[i]->refs, 1, memory_order_relaxed);
     }
+}
 
-    // Clone the graph using DFS
-    cloneGraphUtil(original, cloned, 0, visited, vertexMap);
+// Function to clone a graph by sharing its adjacency and incoming lists, in O(V) plus the size of
+// any edge indexes. Both graphs stay independent: whichever changes a vertex first copies that list.
+struct Graph* cowCloneGraph(struct Graph* original) {
+    if (!original) {
+        return NULL;
+    }
 
-    // Free allocated memory
-    free(visited);
-    free(vertexMap);
+    struct Graph* cloned = createGraph(original->vertices);
+    cloned->listStore = (struct NodeStore**)calloc(original->vertices, sizeof(struct NodeStore*));
+    shareLists(original->vertices, original->adjacencyList, &original->listStore,
+               cloned->adjacencyList, cloned->listStore);
+
+    // With the incoming lists already shared, cloneGraphExtras does not rebuild them
+    if (original->incomingList) {
+        cloned->incomingList = (struct Node**)calloc(original->vertices, sizeof(struct Node*));
+        cloned->incomingStore = (struct NodeStore**)calloc(original->vertices, sizeof(struct NodeStore*));
+        shareLists(original->vertices, original->incomingList, &original->incomingStore,
+                   cloned->incomingList, cloned->incomingStore);
+    }
 
+    cloneGraphExtras(original, cloned);
     return cloned;
-}
\ No newline at end of file
+}
+
+#endif
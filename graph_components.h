@@ -0,0 +1,171 @@
+#ifndef GRAPH_COMPONENTS_H
+#define GRAPH_COMPONENTS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "graph_csr.h"
+
+// Parallel connected components on CSR graphs with a concurrent union-find (Afforest,
+// Sutton et al.). Every vertex first links to a few sampled neighbours; the component
+// that then holds most vertices is skipped while the remaining edges are linked.
+// Links always point from the larger id to the smaller, so every label ends up as the
+// smallest vertex id in its component.
+
+// Neighbours per vertex linked in the sampling phase
+#define CC_NEIGHBOR_ROUNDS 2
+
+// Vertices sampled to guess the largest component
+#define CC_SAMPLE_SIZE 1024
+
+// Shared state of one components run
+struct CCState {
+    const struct CSRGraph* csr;
+    _Atomic uint32_t* comp;
+    uint32_t round;     // Neighbour slot linked by the current sampling round
+    uint32_t skip;      // Component whose vertices the final phase may skip, or UINT32_MAX
+};
+
+// Helper to merge the trees of u and v by hanging the larger root under the smaller one
+void ccLink(_Atomic uint32_t* comp, uint32_t u, uint32_t v) {
+    uint32_t p1 = atomic_load_explicit(&comp[u], memory_order_relaxed);
+    uint32_t p2 = atomic_load_explicit(&comp[v], memory_order_relaxed);
+
+    while (p1 != p2) {
+        uint32_t high = p1 > p2 ? p1 : p2;
+        uint32_t low = p1 + p2 - high;
+        uint32_t pHigh = atomic_load_explicit(&comp[high], memory_order_relaxed);
+        if (pHigh == low) {
+            break;
+        }
+        // Only a root may be relinked, and only once: the CAS fails if another thread got there first
+        uint32_t expected = high;
+        if (pHigh == high &&
+            atomic_compare_exchange_strong_explicit(&comp[high], &expected, low, memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+        p1 = atomic_load_explicit(&comp[atomic_load_explicit(&comp[high], memory_order_relaxed)], memory_order_relaxed);
+        p2 = atomic_load_explicit(&comp[low], memory_order_relaxed);
+    }
+}
+
+// Helper to point every vertex of a slice straight at its root
+void ccCompressSlice(long begin, long end, int worker, void* ctx) {
+    struct CCState* state = (struct CCState*)ctx;
+    _Atomic uint32_t* comp = state->comp;
+    (void)worker;
+    for (long v = begin; v < end; ++v) {
+        uint32_t parent = atomic_load_explicit(&comp[v], memory_order_relaxed);
+        uint32_t grand = atomic_load_explicit(&comp[parent], memory_order_relaxed);
+        while (parent != grand) {
+            atomic_store_explicit(&comp[v], grand, memory_order_relaxed);
+            parent = grand;
+            grand = atomic_load_explicit(&comp[parent], memory_order_relaxed);
+        }
+    }
+}
+
+// Helper for one sampling round: link every vertex of a slice to its neighbour in slot round
+void ccSampleSlice(long begin, long end, int worker, void* ctx) {
+    struct CCState* state = (struct CCState*)ctx;
+    const struct CSRGraph* csr = state->csr;
+    (void)worker;
+    for (long v = begin; v < end; ++v) {
+        uint64_t e = csr->offsets[v] + state->round;
+        if (e < csr->offsets[v + 1]) {
+            ccLink(state->comp, (uint32_t)v, csr->neighbors[e]);
+        }
+    }
+}
+
+// Helper for the final phase: link the unsampled edges of every vertex of a slice outside the
+// skipped component
+void ccFinishSlice(long begin, long end, int worker, void* ctx) {
+    struct CCState* state = (struct CCState*)ctx;
+    const struct CSRGraph* csr = state->csr;
+    (void)worker;
+    for (long v = begin; v < end; ++v) {
+        if (atomic_load_explicit(&state->comp[v], memory_order_relaxed) == state->skip) {
+            continue;
+        }
+        for (uint64_t e = csr->offsets[v] + CC_NEIGHBOR_ROUNDS; e < csr->offsets[v + 1]; ++e) {
+            ccLink(state->comp, (uint32_t)v, csr->neighbors[e]);
+        }
+    }
+}
+
+// Helper to guess the largest component from a fixed sample of vertices
+uint32_t ccMostFrequent(_Atomic uint32_t* comp, uint32_t vertices) {
+    uint32_t* sample = (uint32_t*)malloc(CC_SAMPLE_SIZE * sizeof(uint32_t));
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint32_t best = 0, bestCount = 0;
+
+    for (int i = 0; i < CC_SAMPLE_SIZE; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        sample[i] = atomic_load_explicit(&comp[state % vertices], memory_order_relaxed);
+    }
+    qsort(sample, CC_SAMPLE_SIZE, sizeof(uint32_t), csrCompareIds);
+    for (int i = 0, j; i < CC_SAMPLE_SIZE; i = j) {
+        for (j = i; j < CC_SAMPLE_SIZE && sample[j] == sample[i]; ++j) {
+        }
+        if ((uint32_t)(j - i) > bestCount) {
+            bestCount = (uint32_t)(j - i);
+            best = sample[i];
+        }
+    }
+
+    free(sample);
+    return best;
+}
+
+// Function to label the connected components of a CSR graph using all cores. labels[v] becomes
+// the smallest vertex id in v's component; returns the number of components. Set symmetric if
+// every edge is stored in both directions; otherwise edge direction is ignored (weak components)
+// and the big-component skip is disabled.
+uint32_t csrConnectedComponents(const struct CSRGraph* csr, bool symmetric, uint32_t* labels) {
+    struct CCState state;
+    int workers = parallel_num_threads();
+    uint32_t count = 0;
+
+    if (csr->vertices == 0) {
+        return 0;
+    }
+
+    state.csr = csr;
+    state.comp = (_Atomic uint32_t*)malloc(csr->vertices * sizeof(_Atomic uint32_t));
+    for (uint32_t v = 0; v < csr->vertices; ++v) {
+        atomic_init(&state.comp[v], v);
+    }
+
+    for (state.round = 0; state.round < CC_NEIGHBOR_ROUNDS; ++state.round) {
+        parallel_for(0, csr->vertices, workers, ccSampleSlice, &state);
+        parallel_for(0, csr->vertices, workers, ccCompressSlice, &state);
+    }
+
+    // Skipping the big component is only safe when every edge is seen from both ends
+    state.skip = symmetric ? ccMostFrequent(state.comp, csr->vertices) : UINT32_MAX;
+    parallel_for(0, csr->vertices, workers, ccFinishSlice, &state);
+    parallel_for(0, csr->vertices, workers, ccCompressSlice, &state);
+
+    for (uint32_t v = 0; v < csr->vertices; ++v) {
+        labels[v] = atomic_load_explicit(&state.comp[v], memory_order_relaxed);
+        count += labels[v] == v;
+    }
+    free((void*)state.comp);
+    return count;
+}
+
+// Function to label the connected components of an adjacency-list graph, ignoring edge direction;
+// labels[v] becomes the smallest vertex id in v's component. Returns the number of components.
+int connectedComponents(struct Graph* graph, int* labels) {
+    struct CSRGraph* csr = createCSRFromGraph(graph);
+    uint32_t count = csrConnectedComponents(csr, false, (uint32_t*)labels);
+    freeCSRGraph(csr);
+    return (int)count;
+}
+
+#endif
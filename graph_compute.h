@@ -0,0 +1,247 @@
+#ifndef GRAPH_COMPUTE_H
+#define GRAPH_COMPUTE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "graph_csr.h"
+
+// Iterative vertex-centric engine on CSR graphs. Each iteration every vertex publishes one
+// contribution, then every vertex pulls the contributions of its in-neighbours through a
+// combine operator and computes its new value. Values are double-buffered, so no atomics are
+// needed and each vertex is written by one worker only.
+// Uses fmin, fmax and fabs, so programs including this header must link with -lm.
+
+// How contributions from in-neighbours are combined
+enum GatherOp {
+    GATHER_SUM,
+    GATHER_MIN,
+    GATHER_MAX
+};
+
+// Totals of the previous iteration passed to apply
+struct IterationInfo {
+    int iteration;
+    uint32_t vertices;
+    double sinkMass;  // Sum of the values of vertices with no out-edges
+};
+
+// A kernel run by csrIterate
+struct VertexProgram {
+    enum GatherOp gather;
+    // Value vertex v sends along each of its out-edges
+    double (*contribution)(uint32_t v, double value, uint64_t outDegree, void* ctx);
+    // New value of vertex v from the combined contributions (the identity of gather if none)
+    double (*apply)(uint32_t v, double gathered, double old, const struct IterationInfo* info, void* ctx);
+    void* ctx;
+};
+
+// Statistics of one csrIterate run. iterationSeconds is set by the caller before the run: an
+// array of maxIterations entries that receives the time of each iteration, or NULL.
+struct IterationStats {
+    int iterations;
+    double residual;          // L1 change of the last iteration
+    double seconds;           // Time spent iterating, excluding setup
+    double edgesPerSecond;    // Edges gathered per second, averaged over iterations
+    double* iterationSeconds; // Optional per-iteration times, or NULL
+};
+
+// Shared state of one csrIterate run
+struct IterationState {
+    const struct CSRGraph* incoming;
+    const struct VertexProgram* program;
+    const uint64_t* outDegree;
+    double* values;
+    double* next;
+    double* contrib;
+    double* workerSink;      // Per worker: sink mass of its slice
+    double* workerResidual;  // Per worker: L1 change of its slice
+    struct IterationInfo info;
+};
+
+// Helper to publish the contributions of a slice and total its sink mass
+void iterateScatterSlice(long begin, long end, int worker, void* ctx) {
+    struct IterationState* state = (struct IterationState*)ctx;
+    const struct VertexProgram* program = state->program;
+    double sink = 0;
+
+    for (long v = begin; v < end; ++v) {
+        if (state->outDegree[v] == 0) {
+            sink += state->values[v];
+        }
+        state->contrib[v] = program->contribution((uint32_t)v, state->values[v], state->outDegree[v], program->ctx);
+    }
+    state->workerSink[worker] = sink;
+}
+
+// Helper to pull the contributions of in-neighbours for a slice and apply the kernel
+void iterateGatherSlice(long begin, long end, int worker, void* ctx) {
+    struct IterationState* state = (struct IterationState*)ctx;
+    const struct VertexProgram* program = state->program;
+    const struct CSRGraph* incoming = state->incoming;
+    const double* contrib = state->contrib;
+    double residual = 0;
+
+    for (long v = begin; v < end; ++v) {
+        uint64_t e = incoming->offsets[v], stop = incoming->offsets[v + 1];
+        double acc;
+        if (program->gather == GATHER_SUM) {
+            acc = 0;
+            for (; e < stop; ++e) {
+                acc += contrib[incoming->neighbors[e]];
+            }
+        } else if (program->gather == GATHER_MIN) {
+            acc = INFINITY;
+            for (; e < stop; ++e) {
+                acc = fmin(acc, contrib[incoming->neighbors[e]]);
+            }
+        } else {
+            acc = -INFINITY;
+            for (; e < stop; ++e) {
+                acc = fmax(acc, contrib[incoming->neighbors[e]]);
+            }
+        }
+        state->next[v] = program->apply((uint32_t)v, acc, state->values[v], &state->info, program->ctx);
+        residual += fabs(state->next[v] - state->values[v]);
+    }
+    state->workerResidual[worker] = residual;
+}
+
+// Helper to read the monotonic clock in seconds
+double iterateNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to run a vertex program over incoming, the transpose of the graph (the graph itself if
+// symmetric), starting from values. Stops after maxIterations or once an iteration changes the
+// values by at most tolerance in L1 norm; values holds the result. stats may be NULL.
+void csrIterate(const struct CSRGraph* incoming, const struct VertexProgram* program, double* values,
+                int maxIterations, double tolerance, struct IterationStats* stats) {
+    struct IterationState state;
+    uint32_t vertices = incoming->vertices;
+    int workers = parallel_num_threads();
+
+    // Out-degrees are the occurrences of each vertex in the in-neighbour lists
+    _Atomic uint64_t* counts = (_Atomic uint64_t*)calloc((size_t)vertices + 1, sizeof(_Atomic uint64_t));
+    struct CSRTransposeBuild count = { incoming, NULL, counts };
+    parallel_for(0, vertices, workers, csrTransposeCountSlice, &count);
+    uint64_t* outDegree = (uint64_t*)malloc(((size_t)vertices + 1) * sizeof(uint64_t));
+    for (uint32_t v = 0; v < vertices; ++v) {
+        outDegree[v] = atomic_load_explicit(&counts[v], memory_order_relaxed);
+    }
+    free((void*)counts);
+
+    state.incoming = incoming;
+    state.program = program;
+    state.outDegree = outDegree;
+    state.values = values;
+    state.next = (double*)malloc(((size_t)vertices + 1) * sizeof(double));
+    state.contrib = (double*)malloc(((size_t)vertices + 1) * sizeof(double));
+    state.workerSink = (double*)calloc(workers, sizeof(double));
+    state.workerResidual = (double*)calloc(workers, sizeof(double));
+    state.info.vertices = vertices;
+
+    double residual = INFINITY;
+    int iteration = 0;
+    double start = iterateNow();
+    double* iterationSeconds = stats != NULL ? stats->iterationSeconds : NULL;
+    while (iteration < maxIterations && residual > tolerance) {
+        double iterationStart = iterateNow();
+        state.info.iteration = iteration;
+        memset(state.workerSink, 0, workers * sizeof(double));
+        parallel_for(0, vertices, workers, iterateScatterSlice, &state);
+        state.info.sinkMass = 0;
+        for (int w = 0; w < workers; ++w) {
+            state.info.sinkMass += state.workerSink[w];
+        }
+
+        memset(state.workerResidual, 0, workers * sizeof(double));
+        parallel_for(0, vertices, workers, iterateGatherSlice, &state);
+        residual = 0;
+        for (int w = 0; w < workers; ++w) {
+            residual += state.workerResidual[w];
+        }
+
+        double* swap = state.values;
+        state.values = state.next;
+        state.next = swap;
+        if (iterationSeconds != NULL) {
+            iterationSeconds[iteration] = iterateNow() - iterationStart;
+        }
+        iteration++;
+    }
+
+    // After an odd number of swaps the result sits in the scratch buffer
+    if (state.values != values) {
+        memcpy(values, state.values, (size_t)vertices * sizeof(double));
+        state.next = state.values;
+    }
+
+    if (stats != NULL) {
+        stats->iterations = iteration;
+        stats->residual = residual;
+        stats->seconds = iterateNow() - start;
+        stats->edgesPerSecond = stats->seconds > 0 ? (double)incoming->edges * iteration / stats->seconds : 0;
+    }
+
+    free(outDegree);
+    free(state.next);
+    free(state.contrib);
+    free(state.workerSink);
+    free(state.workerResidual);
+}
+
+// Parameters of a PageRank run
+struct PageRankParams {
+    double damping;
+    const double* personalization;  // Restart distribution summing to 1, or NULL for uniform
+};
+
+// PageRank kernel: each vertex sends rank / out-degree along its out-edges
+double pageRankContribution(uint32_t v, double value, uint64_t outDegree, void* ctx) {
+    (void)v;
+    (void)ctx;
+    return outDegree > 0 ? value / (double)outDegree : 0;
+}
+
+// PageRank kernel: restarts and the rank of dangling vertices follow the restart distribution
+double pageRankApply(uint32_t v, double gathered, double old, const struct IterationInfo* info, void* ctx) {
+    const struct PageRankParams* params = (const struct PageRankParams*)ctx;
+    double restart = params->personalization ? params->personalization[v] : 1.0 / info->vertices;
+    (void)old;
+    return (1 - params->damping) * restart + params->damping * (gathered + info->sinkMass * restart);
+}
+
+// Function to compute PageRank over incoming, the transpose of the graph (the graph itself if
+// symmetric). personalization is an optional restart distribution summing to 1. ranks receives
+// the result and sums to 1. Returns the number of iterations run; stats may be NULL.
+int csrPageRank(const struct CSRGraph* incoming, double damping, const double* personalization,
+                int maxIterations, double tolerance, double* ranks, struct IterationStats* stats) {
+    struct PageRankParams params = { damping, personalization };
+    struct VertexProgram program = { GATHER_SUM, pageRankContribution, pageRankApply, &params };
+    struct IterationStats local = { 0, 0, 0, 0, NULL };
+
+    for (uint32_t v = 0; v < incoming->vertices; ++v) {
+        ranks[v] = personalization ? personalization[v] : 1.0 / incoming->vertices;
+    }
+    csrIterate(incoming, &program, ranks, maxIterations, tolerance, stats ? stats : &local);
+    return stats ? stats->iterations : local.iterations;
+}
+
+// Function to compute PageRank on an adjacency-list graph; see csrPageRank
+int pageRank(struct Graph* graph, double damping, int maxIterations, double tolerance, double* ranks) {
+    struct CSRGraph* csr = createCSRFromGraph(graph);
+    struct CSRGraph* incoming = createCSRTranspose(csr);
+    freeCSRGraph(csr);
+    int iterations = csrPageRank(incoming, damping, NULL, maxIterations, tolerance, ranks, NULL);
+    freeCSRGraph(incoming);
+    return iterations;
+}
+
+#endif
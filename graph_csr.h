@@ -0,0 +1,855 @@
+#ifndef GRAPH_CSR_H
+#define GRAPH_CSR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include "graph.h"
+#include "parallel.h"
+
+// Immutable graph in compressed sparse row form: the neighbours of vertex v
+// are neighbors[offsets[v] .. offsets[v + 1]), stored as 32-bit vertex ids.
+// weights[e] is the weight of edge e, or weights is NULL when every edge weighs 1.
+struct CSRGraph {
+    uint32_t vertices;
+    uint64_t edges;
+    uint64_t* offsets;
+    uint32_t* neighbors;
+    int* weights;
+};
+
+// Function to allocate a CSR graph with room for the given number of edges
+struct CSRGraph* createCSRGraph(uint32_t vertices, uint64_t edges) {
+    struct CSRGraph* csr = (struct CSRGraph*)malloc(sizeof(struct CSRGraph));
+    csr->vertices = vertices;
+    csr->edges = edges;
+    csr->offsets = (uint64_t*)calloc((size_t)vertices + 1, sizeof(uint64_t));
+    csr->neighbors = (uint32_t*)malloc((edges > 0 ? edges : 1) * sizeof(uint32_t));
+    csr->weights = NULL;
+    return csr;
+}
+
+// Function to free a CSR graph
+void freeCSRGraph(struct CSRGraph* csr) {
+    free(csr->offsets);
+    free(csr->neighbors);
+    free(csr->weights);
+    free(csr);
+}
+
+// Function to get the out-degree of a vertex in O(1)
+uint64_t csrDegree(const struct CSRGraph* csr, uint32_t vertex) {
+    return csr->offsets[vertex + 1] - csr->offsets[vertex];
+}
+
+// Shared state for the parallel passes of createCSRFromEdges
+struct CSRBuild {
+    struct CSRGraph* csr;
+    const uint32_t* src;
+    const uint32_t* dst;
+    bool undirected;
+    _Atomic uint64_t* cursor; // Per-vertex degree, then per-vertex write position
+};
+
+// Helper to count the out-degree contributed by a slice of the edge list
+void csrCountSlice(long begin, long end, int worker, void* ctx) {
+    struct CSRBuild* build = (struct CSRBuild*)ctx;
+    (void)worker;
+    for (long i = begin; i < end; ++i) {
+        atomic_fetch_add_explicit(&build->cursor[build->src[i]], 1, memory_order_relaxed);
+        if (build->undirected) {
+            atomic_fetch_add_explicit(&build->cursor[build->dst[i]], 1, memory_order_relaxed);
+        }
+    }
+}
+
+// Helper to place a slice of the edge list into the neighbour array
+void csrScatterSlice(long begin, long end, int worker, void* ctx) {
+    struct CSRBuild* build = (struct CSRBuild*)ctx;
+    uint32_t* neighbors = build->csr->neighbors;
+    (void)worker;
+    for (long i = begin; i < end; ++i) {
+        uint32_t u = build->src[i], v = build->dst[i];
+        neighbors[atomic_fetch_add_explicit(&build->cursor[u], 1, memory_order_relaxed)] = v;
+        if (build->undirected) {
+            neighbors[atomic_fetch_add_explicit(&build->cursor[v], 1, memory_order_relaxed)] = u;
+        }
+    }
+}
+
+// Helper for qsort on vertex ids
+int csrCompareIds(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Neighbour lists up to this long are sorted by insertion sort
+#define CSR_SORT_INSERTION_MAX 32
+
+// Neighbour id paired with its edge weight, for sorting weighted lists
+struct CSRWeightedEdge {
+    uint32_t id;
+    int weight;
+};
+
+// Helper for qsort on weighted edges by neighbour id
+int csrCompareWeightedEdges(const void* a, const void* b) {
+    uint32_t x = ((const struct CSRWeightedEdge*)a)->id, y = ((const struct CSRWeightedEdge*)b)->id;
+    return (x > y) - (x < y);
+}
+
+// Helper to sort one weighted neighbour list, moving each weight with its id
+void csrSortWeightedList(uint32_t* list, int* weights, uint64_t degree) {
+    if (degree > CSR_SORT_INSERTION_MAX) {
+        struct CSRWeightedEdge* edges = (struct CSRWeightedEdge*)malloc(degree * sizeof(struct CSRWeightedEdge));
+        for (uint64_t i = 0; i < degree; ++i) {
+            edges[i].id = list[i];
+            edges[i].weight = weights[i];
+        }
+        qsort(edges, degree, sizeof(struct CSRWeightedEdge), csrCompareWeightedEdges);
+        for (uint64_t i = 0; i < degree; ++i) {
+            list[i] = edges[i].id;
+            weights[i] = edges[i].weight;
+        }
+        free(edges);
+        return;
+    }
+    for (uint64_t i = 1; i < degree; ++i) {
+        uint32_t id = list[i];
+        int weight = weights[i];
+        uint64_t j = i;
+        for (; j > 0 && list[j - 1] > id; --j) {
+            list[j] = list[j - 1];
+            weights[j] = weights[j - 1];
+        }
+        list[j] = id;
+        weights[j] = weight;
+    }
+}
+
+// Helper to sort the neighbour lists of a slice of vertices, together with their weights if any
+void csrSortSlice(long begin, long end, int worker, void* ctx) {
+    struct CSRGraph* csr = (struct CSRGraph*)ctx;
+    (void)worker;
+    for (long v = begin; v < end; ++v) {
+        uint32_t* list = csr->neighbors + csr->offsets[v];
+        uint64_t degree = csr->offsets[v + 1] - csr->offsets[v];
+        if (csr->weights) {
+            csrSortWeightedList(list, csr->weights + csr->offsets[v], degree);
+            continue;
+        }
+        if (degree > CSR_SORT_INSERTION_MAX) {
+            qsort(list, degree, sizeof(uint32_t), csrCompareIds);
+            continue;
+        }
+        // Most lists are short, where insertion sort beats qsort's per-call overhead
+        for (uint64_t i = 1; i < degree; ++i) {
+            uint32_t id = list[i];
+            uint64_t j = i;
+            for (; j > 0 && list[j - 1] > id; --j) {
+                list[j] = list[j - 1];
+            }
+            list[j] = id;
+        }
+    }
+}
+
+// Helper to turn per-vertex counts in cursor into offsets, leaving cursor at each row start
+void csrPrefixSum(struct CSRGraph* csr, _Atomic uint64_t* cursor) {
+    uint64_t running = 0;
+    for (uint32_t v = 0; v < csr->vertices; ++v) {
+        csr->offsets[v] = running;
+        running += atomic_load_explicit(&cursor[v], memory_order_relaxed);
+        atomic_store_explicit(&cursor[v], csr->offsets[v], memory_order_relaxed);
+    }
+    csr->offsets[csr->vertices] = running;
+}
+
+// Function to build a CSR graph from an edge list using all cores.
+// With undirected set every edge is stored in both directions, like addEdge.
+// Neighbour lists come out sorted by vertex id.
+struct CSRGraph* createCSRFromEdges(uint32_t vertices, const uint32_t* src, const uint32_t* dst,
+                                    uint64_t edgeCount, bool undirected) {
+    struct CSRGraph* csr = createCSRGraph(vertices, undirected ? 2 * edgeCount : edgeCount);
+    struct CSRBuild build = { csr, src, dst, undirected, NULL };
+    int workers = parallel_num_threads();
+
+    build.cursor = (_Atomic uint64_t*)calloc((size_t)vertices + 1, sizeof(_Atomic uint64_t));
+    parallel_for(0, (long)edgeCount, workers, csrCountSlice, &build);
+    csrPrefixSum(csr, build.cursor);
+    parallel_for(0, (long)edgeCount, workers, csrScatterSlice, &build);
+    parallel_for(0, (long)vertices, workers, csrSortSlice, csr);
+
+    free((void*)build.cursor);
+    return csr;
+}
+
+// Helper to copy the adjacency lists of a slice of vertices, keeping list order
+void csrCopyListsSlice(long begin, long end, int worker, void* ctx) {
+    void** args = (void**)ctx;
+    struct Graph* graph = (struct Graph*)args[0];
+    struct CSRGraph* csr = (struct CSRGraph*)args[1];
+    (void)worker;
+    for (long v = begin; v < end; ++v) {
+        uint64_t pos = csr->offsets[v];
+        for (struct Node* current = graph->adjacencyList[v]; current; current = current->next) {
+            if (csr->weights) {
+                csr->weights[pos] = current->weight;
+            }
+            csr->neighbors[pos++] = (uint32_t)current->data;
+        }
+    }
+}
+
+// Function to build a CSR graph from an adjacency-list graph, keeping each list's order.
+// Edge weights are copied unless every edge weighs 1.
+struct CSRGraph* createCSRFromGraph(struct Graph* graph) {
+    uint64_t edges = 0;
+    bool weighted = false;
+    uint64_t* degree = (uint64_t*)malloc(((size_t)graph->vertices + 1) * sizeof(uint64_t));
+
+    for (int v = 0; v < graph->vertices; ++v) {
+        degree[v] = 0;
+        for (struct Node* current = graph->adjacencyList[v]; current; current = current->next) {
+            degree[v]++;
+            weighted = weighted || current->weight != 1;
+        }
+        edges += degree[v];
+    }
+
+    struct CSRGraph* csr = createCSRGraph((uint32_t)graph->vertices, edges);
+    if (weighted) {
+        csr->weights = (int*)malloc((edges > 0 ? edges : 1) * sizeof(int));
+    }
+    uint64_t running = 0;
+    for (int v = 0; v < graph->vertices; ++v) {
+        csr->offsets[v] = running;
+        running += degree[v];
+    }
+    csr->offsets[graph->vertices] = running;
+    free(degree);
+
+    void* args[2] = { graph, csr };
+    parallel_for(0, graph->vertices, parallel_num_threads(), csrCopyListsSlice, args);
+    return csr;
+}
+
+// Function to fill order with the vertices reached by BFS from startVertex; returns how many
+uint32_t csrBfsOrder(const struct CSRGraph* csr, uint32_t startVertex, uint32_t* order) {
+    bool* visited = (bool*)calloc(csr->vertices, sizeof(bool));
+    uint32_t head = 0, tail = 0;
+
+    visited[startVertex] = true;
+    order[tail++] = startVertex;
+    while (head < tail) {
+        uint32_t u = order[head++];
+        for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+            uint32_t v = csr->neighbors[e];
+            if (!visited[v]) {
+                visited[v] = true;
+                order[tail++] = v;
+            }
+        }
+    }
+
+    free(visited);
+    return tail;
+}
+
+// Function to perform Breadth-First Search (BFS) on a CSR graph
+void csrBfs(const struct CSRGraph* csr, uint32_t startVertex) {
+    uint32_t* order = (uint32_t*)malloc(csr->vertices * sizeof(uint32_t));
+    uint32_t count = csrBfsOrder(csr, startVertex, order);
+
+    printf("BFS starting from vertex %u: ", startVertex);
+    for (uint32_t i = 0; i < count; ++i) {
+        printf("%u ", order[i]);
+    }
+    printf("\n");
+    free(order);
+}
+
+// Function to fill order with the vertices reached by DFS from startVertex, in the same order
+// as the recursive dfs(); uses an explicit stack with a neighbour cursor per level
+uint32_t csrDfsOrder(const struct CSRGraph* csr, uint32_t startVertex, uint32_t* order) {
+    bool* visited = (bool*)calloc(csr->vertices, sizeof(bool));
+    uint32_t* stack = (uint32_t*)malloc(csr->vertices * sizeof(uint32_t));
+    uint64_t* cursor = (uint64_t*)malloc(csr->vertices * sizeof(uint64_t));
+    uint32_t count = 0, top = 0;
+
+    visited[startVertex] = true;
+    order[count++] = startVertex;
+    stack[top] = startVertex;
+    cursor[top++] = csr->offsets[startVertex];
+    while (top > 0) {
+        uint32_t u = stack[top - 1];
+        if (cursor[top - 1] == csr->offsets[u + 1]) {
+            top--;
+            continue;
+        }
+        uint32_t v = csr->neighbors[cursor[top - 1]++];
+        if (!visited[v]) {
+            visited[v] = true;
+            order[count++] = v;
+            stack[top] = v;
+            cursor[top++] = csr->offsets[v];
+        }
+    }
+
+    free(visited);
+    free(stack);
+    free(cursor);
+    return count;
+}
+
+// Function to perform Depth-First Search (DFS) on a CSR graph
+void csrDfs(const struct CSRGraph* csr, uint32_t startVertex) {
+    uint32_t* order = (uint32_t*)malloc(csr->vertices * sizeof(uint32_t));
+    uint32_t count = csrDfsOrder(csr, startVertex, order);
+
+    printf("DFS starting from vertex %u: ", startVertex);
+    for (uint32_t i = 0; i < count; ++i) {
+        printf("%u ", order[i]);
+    }
+    printf("\n");
+    free(order);
+}
+
+// Function to fill result with a DFS-based topological order (same order as topologicalSort())
+void csrTopologicalOrder(const struct CSRGraph* csr, uint32_t* result) {
+    bool* visited = (bool*)calloc(csr->vertices, sizeof(bool));
+    uint32_t* stack = (uint32_t*)malloc(csr->vertices * sizeof(uint32_t));
+    uint64_t* cursor = (uint64_t*)malloc(csr->vertices * sizeof(uint64_t));
+    int64_t index = (int64_t)csr->vertices - 1;
+
+    for (uint32_t s = 0; s < csr->vertices; ++s) {
+        if (visited[s]) {
+            continue;
+        }
+        uint32_t top = 0;
+        visited[s] = true;
+        stack[top] = s;
+        cursor[top++] = csr->offsets[s];
+        while (top > 0) {
+            uint32_t u = stack[top - 1];
+            if (cursor[top - 1] == csr->offsets[u + 1]) {
+                // All descendants done: u goes in front of them
+                result[index--] = u;
+                top--;
+                continue;
+            }
+            uint32_t v = csr->neighbors[cursor[top - 1]++];
+            if (!visited[v]) {
+                visited[v] = true;
+                stack[top] = v;
+                cursor[top++] = csr->offsets[v];
+            }
+        }
+    }
+
+    free(visited);
+    free(stack);
+    free(cursor);
+}
+
+// Function to perform topological sort on a CSR graph
+void csrTopologicalSort(const struct CSRGraph* csr) {
+    uint32_t* result = (uint32_t*)malloc(csr->vertices * sizeof(uint32_t));
+    csrTopologicalOrder(csr, result);
+
+    printf("Topological Sort: ");
+    for (uint32_t i = 0; i < csr->vertices; ++i) {
+        printf("%u ", result[i]);
+    }
+    printf("\n");
+    free(result);
+}
+
+// Function to find a cycle in a directed CSR graph. Returns its length (0 if the graph is
+// acyclic) and, unless cycle is NULL, writes its vertices there in edge order.
+uint32_t csrFindCycle(const struct CSRGraph* csr, uint32_t* cycle) {
+    // 0 = unvisited, 1 = on the current DFS path, 2 = finished
+    unsigned char* state = (unsigned char*)calloc(csr->vertices, 1);
+    uint32_t* stack = (uint32_t*)malloc(csr->vertices * sizeof(uint32_t));
+    uint64_t* cursor = (uint64_t*)malloc(csr->vertices * sizeof(uint64_t));
+    uint32_t length = 0;
+
+    for (uint32_t s = 0; s < csr->vertices && length == 0; ++s) {
+        if (state[s] != 0) {
+            continue;
+        }
+        uint32_t top = 0;
+        state[s] = 1;
+        stack[top] = s;
+        cursor[top++] = csr->offsets[s];
+        while (top > 0 && length == 0) {
+            uint32_t u = stack[top - 1];
+            if (cursor[top - 1] == csr->offsets[u + 1]) {
+                state[u] = 2;
+                top--;
+                continue;
+            }
+            uint32_t v = csr->neighbors[cursor[top - 1]++];
+            if (state[v] == 1) {
+                // v is on the current path: the path from v to u closes a cycle
+                uint32_t start = top - 1;
+                while (stack[start] != v) {
+                    start--;
+                }
+                length = top - start;
+                if (cycle != NULL) {
+                    memcpy(cycle, stack + start, length * sizeof(uint32_t));
+                }
+            } else if (state[v] == 0) {
+                state[v] = 1;
+                stack[top] = v;
+                cursor[top++] = csr->offsets[v];
+            }
+        }
+    }
+
+    free(state);
+    free(stack);
+    free(cursor);
+    return length;
+}
+
+// Function to detect cycles in a directed CSR graph
+bool csrHasCycle(const struct CSRGraph* csr) {
+    return csrFindCycle(csr, NULL) > 0;
+}
+
+// Helper for csrShortestPaths on a weighted CSR graph: Dijkstra over the indexed heap
+void csrWeightedShortestPaths(const struct CSRGraph* csr, uint32_t startVertex, int* distance) {
+    struct IndexedHeap* heap = createIndexedHeap((int)csr->vertices, distance);
+
+    for (uint32_t i = 0; i < csr->vertices; ++i) {
+        distance[i] = INT_MAX;
+    }
+    distance[startVertex] = 0;
+    heapPushOrDecrease(heap, (int)startVertex);
+
+    while (heap->size > 0) {
+        int u = heapPopMin(heap);
+        for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+            uint32_t v = csr->neighbors[e];
+            int weight = csr->weights[e];
+            // Skip edges whose distance would overflow
+            if (weight <= INT_MAX - distance[u] && distance[u] + weight < distance[v]) {
+                distance[v] = distance[u] + weight;
+                heapPushOrDecrease(heap, (int)v);
+            }
+        }
+    }
+
+    freeIndexedHeap(heap);
+}
+
+// Function to compute shortest path lengths from startVertex. Weighted graphs run Dijkstra;
+// without weights every edge weighs 1 and a BFS is exact. Unreachable vertices get INT_MAX.
+void csrShortestPaths(const struct CSRGraph* csr, uint32_t startVertex, int* distance) {
+    if (csr->weights != NULL) {
+        csrWeightedShortestPaths(csr, startVertex, distance);
+        return;
+    }
+
+    uint32_t* queue = (uint32_t*)malloc(csr->vertices * sizeof(uint32_t));
+    uint32_t head = 0, tail = 0;
+
+    for (uint32_t i = 0; i < csr->vertices; ++i) {
+        distance[i] = INT_MAX;
+    }
+    distance[startVertex] = 0;
+    queue[tail++] = startVertex;
+    while (head < tail) {
+        uint32_t u = queue[head++];
+        for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+            uint32_t v = csr->neighbors[e];
+            if (distance[v] == INT_MAX) {
+                distance[v] = distance[u] + 1;
+                queue[tail++] = v;
+            }
+        }
+    }
+    free(queue);
+}
+
+// Function to perform Dijkstra's algorithm on a CSR graph
+void csrDijkstra(const struct CSRGraph* csr, uint32_t startVertex) {
+    int* distance = (int*)malloc(csr->vertices * sizeof(int));
+    csrShortestPaths(csr, startVertex, distance);
+    printDijkstra(distance, (int)csr->vertices, (int)startVertex);
+    free(distance);
+}
+
+// Shared state for the parallel passes of createCSRTranspose
+struct CSRTransposeBuild {
+    const struct CSRGraph* csr;
+    struct CSRGraph* transpose;
+    _Atomic uint64_t* cursor;
+};
+
+// Helper to count the in-degree contributed by a slice of source vertices
+void csrTransposeCountSlice(long begin, long end, int worker, void* ctx) {
+    struct CSRTransposeBuild* build = (struct CSRTransposeBuild*)ctx;
+    const struct CSRGraph* csr = build->csr;
+    (void)worker;
+    for (long u = begin; u < end; ++u) {
+        for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+            atomic_fetch_add_explicit(&build->cursor[csr->neighbors[e]], 1, memory_order_relaxed);
+        }
+    }
+}
+
+// Helper to place the reversed edges of a slice of source vertices
+void csrTransposeScatterSlice(long begin, long end, int worker, void* ctx) {
+    struct CSRTransposeBuild* build = (struct CSRTransposeBuild*)ctx;
+    const struct CSRGraph* csr = build->csr;
+    (void)worker;
+    for (long u = begin; u < end; ++u) {
+        for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+            uint64_t pos = atomic_fetch_add_explicit(&build->cursor[csr->neighbors[e]], 1, memory_order_relaxed);
+            build->transpose->neighbors[pos] = (uint32_t)u;
+        }
+    }
+}
+
+// Function to build the transpose of a CSR graph (the in-neighbours of every vertex), sorted by id;
+// edge weights are not carried over
+struct CSRGraph* createCSRTranspose(const struct CSRGraph* csr) {
+    struct CSRGraph* transpose = createCSRGraph(csr->vertices, csr->edges);
+    struct CSRTransposeBuild build = { csr, transpose, NULL };
+    int workers = parallel_num_threads();
+
+    build.cursor = (_Atomic uint64_t*)calloc((size_t)csr->vertices + 1, sizeof(_Atomic uint64_t));
+    parallel_for(0, csr->vertices, workers, csrTransposeCountSlice, &build);
+    csrPrefixSum(transpose, build.cursor);
+    parallel_for(0, csr->vertices, workers, csrTransposeScatterSlice, &build);
+    parallel_for(0, csr->vertices, workers, csrSortSlice, transpose);
+
+    free((void*)build.cursor);
+    return transpose;
+}
+
+// Direction-optimizing BFS switches to bottom-up steps once the frontier's edges exceed
+// 1/CSR_BFS_ALPHA of the unexplored edges, and back once the frontier holds fewer than
+// 1/CSR_BFS_BETA of the vertices (Beamer et al.)
+#define CSR_BFS_ALPHA 15
+#define CSR_BFS_BETA 18
+
+// Frontiers smaller than this are expanded on the calling thread
+#define CSR_BFS_PARALLEL_CUTOFF 1024
+
+// Shared state of one parallel BFS
+struct CSRBfsState {
+    const struct CSRGraph* csr;
+    const struct CSRGraph* incoming;
+    int* parent;
+    int* level;
+    int depth;                  // Level of the current frontier
+    _Atomic uint64_t* visited;  // One bit per vertex
+    uint64_t* front;            // Current frontier as a bitmap (bottom-up steps)
+    uint64_t* next;             // Next frontier as a bitmap (bottom-up steps)
+    uint32_t* queue;            // Current frontier as a list (top-down steps)
+    uint32_t* nextQueue;        // Next frontier as a list (top-down steps)
+    _Atomic uint64_t nextSize;
+    _Atomic uint64_t nextEdges; // Out-edges of the next frontier
+};
+
+// Helper to claim an unvisited vertex; true only for the one caller that sets its bit
+bool csrBfsClaim(_Atomic uint64_t* visited, uint32_t v) {
+    uint64_t bit = 1ull << (v & 63);
+    if (atomic_load_explicit(&visited[v >> 6], memory_order_relaxed) & bit) {
+        return false;
+    }
+    return !(atomic_fetch_or_explicit(&visited[v >> 6], bit, memory_order_relaxed) & bit);
+}
+
+// Helper for a top-down step over a slice of the frontier list; each worker collects its
+// discoveries in a private buffer and appends them to the next frontier in one block
+void csrBfsTopDownSlice(long begin, long end, int worker, void* ctx) {
+    struct CSRBfsState* state = (struct CSRBfsState*)ctx;
+    const struct CSRGraph* csr = state->csr;
+    uint64_t capacity = 256, count = 0, edges = 0;
+    uint32_t* local = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+    (void)worker;
+
+    for (long i = begin; i < end; ++i) {
+        uint32_t u = state->queue[i];
+        for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+            uint32_t v = csr->neighbors[e];
+            if (csrBfsClaim(state->visited, v)) {
+                state->parent[v] = (int)u;
+                state->level[v] = state->depth + 1;
+                if (count == capacity) {
+                    capacity *= 2;
+                    local = (uint32_t*)realloc(local, capacity * sizeof(uint32_t));
+                }
+                local[count++] = v;
+                edges += csr->offsets[v + 1] - csr->offsets[v];
+            }
+        }
+    }
+
+    uint64_t at = atomic_fetch_add_explicit(&state->nextSize, count, memory_order_relaxed);
+    memcpy(state->nextQueue + at, local, count * sizeof(uint32_t));
+    atomic_fetch_add_explicit(&state->nextEdges, edges, memory_order_relaxed);
+    free(local);
+}
+
+// Helper for a bottom-up step over a slice of bitmap words; every unvisited vertex looks for
+// any in-neighbour in the frontier. Workers own whole words, so no atomics are needed on them.
+void csrBfsBottomUpSlice(long begin, long end, int worker, void* ctx) {
+    struct CSRBfsState* state = (struct CSRBfsState*)ctx;
+    const struct CSRGraph* csr = state->csr;
+    const struct CSRGraph* incoming = state->incoming;
+    uint64_t count = 0, edges = 0;
+    (void)worker;
+
+    for (long w = begin; w < end; ++w) {
+        uint64_t seen = atomic_load_explicit(&state->visited[w], memory_order_relaxed);
+        uint64_t found = 0;
+        for (uint32_t b = 0; b < 64; ++b) {
+            uint32_t v = (uint32_t)(w * 64 + b);
+            if (v >= csr->vertices) {
+                break;
+            }
+            if (seen & (1ull << b)) {
+                continue;
+            }
+            for (uint64_t e = incoming->offsets[v]; e < incoming->offsets[v + 1]; ++e) {
+                uint32_t u = incoming->neighbors[e];
+                if (state->front[u >> 6] & (1ull << (u & 63))) {
+                    state->parent[v] = (int)u;
+                    state->level[v] = state->depth + 1;
+                    found |= 1ull << b;
+                    count++;
+                    edges += csr->offsets[v + 1] - csr->offsets[v];
+                    break;
+                }
+            }
+        }
+        state->next[w] = found;
+        atomic_store_explicit(&state->visited[w], seen | found, memory_order_relaxed);
+    }
+
+    atomic_fetch_add_explicit(&state->nextSize, count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&state->nextEdges, edges, memory_order_relaxed);
+}
+
+// Function to run a parallel direction-optimizing BFS from startVertex. Fills parent (startVertex
+// for itself, -1 if unreached) and level (-1 if unreached); returns the number of vertices reached.
+// incoming is the transpose of csr (createCSRTranspose), or NULL if csr is symmetric, e.g. built
+// from addEdge or with undirected set.
+uint32_t csrParallelBfs(const struct CSRGraph* csr, const struct CSRGraph* incoming, uint32_t startVertex,
+                        int* parent, int* level) {
+    uint32_t vertices = csr->vertices;
+    size_t words = ((size_t)vertices + 63) / 64;
+    int workers = parallel_num_threads();
+    struct CSRBfsState state;
+    bool bottomUp = false;
+    uint64_t frontierSize = 1, frontierEdges = csrDegree(csr, startVertex);
+    uint64_t unexploredEdges = csr->edges - frontierEdges;
+    uint32_t reached = 1;
+
+    state.csr = csr;
+    state.incoming = incoming != NULL ? incoming : csr;
+    state.parent = parent;
+    state.level = level;
+    state.depth = 0;
+    state.visited = (_Atomic uint64_t*)calloc(words, sizeof(_Atomic uint64_t));
+    state.front = (uint64_t*)calloc(words, sizeof(uint64_t));
+    state.next = (uint64_t*)calloc(words, sizeof(uint64_t));
+    state.queue = (uint32_t*)malloc(vertices * sizeof(uint32_t));
+    state.nextQueue = (uint32_t*)malloc(vertices * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < vertices; ++i) {
+        parent[i] = -1;
+        level[i] = -1;
+    }
+    parent[startVertex] = (int)startVertex;
+    level[startVertex] = 0;
+    atomic_store_explicit(&state.visited[startVertex >> 6], 1ull << (startVertex & 63), memory_order_relaxed);
+    state.queue[0] = startVertex;
+
+    while (frontierSize > 0) {
+        // Pick the direction for this step, converting the frontier if it changes
+        if (!bottomUp && frontierEdges > unexploredEdges / CSR_BFS_ALPHA) {
+            memset(state.front, 0, words * sizeof(uint64_t));
+            for (uint64_t i = 0; i < frontierSize; ++i) {
+                state.front[state.queue[i] >> 6] |= 1ull << (state.queue[i] & 63);
+            }
+            bottomUp = true;
+        } else if (bottomUp && frontierSize < vertices / CSR_BFS_BETA) {
+            uint64_t count = 0;
+            for (size_t w = 0; w < words; ++w) {
+                for (uint64_t bits = state.front[w]; bits; bits &= bits - 1) {
+                    state.queue[count++] = (uint32_t)(w * 64 + __builtin_ctzll(bits));
+                }
+            }
+            bottomUp = false;
+        }
+
+        atomic_store_explicit(&state.nextSize, 0, memory_order_relaxed);
+        atomic_store_explicit(&state.nextEdges, 0, memory_order_relaxed);
+        if (bottomUp) {
+            parallel_for(0, (long)words, workers, csrBfsBottomUpSlice, &state);
+            uint64_t* swap = state.front;
+            state.front = state.next;
+            state.next = swap;
+        } else {
+            int stepWorkers = frontierSize < CSR_BFS_PARALLEL_CUTOFF ? 1 : workers;
+            parallel_for(0, (long)frontierSize, stepWorkers, csrBfsTopDownSlice, &state);
+            uint32_t* swap = state.queue;
+            state.queue = state.nextQueue;
+            state.nextQueue = swap;
+        }
+
+        frontierSize = atomic_load_explicit(&state.nextSize, memory_order_relaxed);
+        frontierEdges = atomic_load_explicit(&state.nextEdges, memory_order_relaxed);
+        unexploredEdges -= frontierEdges < unexploredEdges ? frontierEdges : unexploredEdges;
+        reached += (uint32_t)frontierSize;
+        state.depth++;
+    }
+
+    free((void*)state.visited);
+    free(state.front);
+    free(state.next);
+    free(state.queue);
+    free(state.nextQueue);
+    return reached;
+}
+
+// Function to run csrParallelBfs on an adjacency-list graph; the graph may hold directed edges,
+// so the bottom-up steps always get the transpose
+uint32_t parallelBfs(struct Graph* graph, int startVertex, int* parent, int* level) {
+    struct CSRGraph* csr = createCSRFromGraph(graph);
+    struct CSRGraph* incoming = createCSRTranspose(csr);
+    uint32_t reached = csrParallelBfs(csr, incoming, (uint32_t)startVertex, parent, level);
+    freeCSRGraph(incoming);
+    freeCSRGraph(csr);
+    return reached;
+}
+
+// Frontiers smaller than this are processed on the calling thread by csrParallelTopologicalSort
+#define CSR_TOPO_PARALLEL_CUTOFF 1024
+
+// Shared state of one parallel Kahn topological sort
+struct CSRTopoState {
+    const struct CSRGraph* csr;
+    _Atomic uint32_t* inDegree;
+    uint32_t* order;          // Sorted prefix; the current frontier is order[head, tail)
+    _Atomic uint64_t tail;
+};
+
+// Helper to count the in-degrees contributed by a slice of vertices
+void csrTopoCountSlice(long begin, long end, int worker, void* ctx) {
+    struct CSRTopoState* state = (struct CSRTopoState*)ctx;
+    (void)worker;
+    for (long u = begin; u < end; ++u) {
+        for (uint64_t e = state->csr->offsets[u]; e < state->csr->offsets[u + 1]; ++e) {
+            atomic_fetch_add_explicit(&state->inDegree[state->csr->neighbors[e]], 1, memory_order_relaxed);
+        }
+    }
+}
+
+// Helper to append the vertices in local to the sorted order in one block
+void csrTopoFlush(struct CSRTopoState* state, const uint32_t* local, uint64_t count) {
+    uint64_t at = atomic_fetch_add_explicit(&state->tail, count, memory_order_relaxed);
+    memcpy(state->order + at, local, count * sizeof(uint32_t));
+}
+
+// Helper to seed the first frontier with the in-degree-zero vertices of a slice
+void csrTopoSeedSlice(long begin, long end, int worker, void* ctx) {
+    struct CSRTopoState* state = (struct CSRTopoState*)ctx;
+    uint64_t count = 0;
+    uint32_t* local = (uint32_t*)malloc((end - begin) * sizeof(uint32_t));
+    (void)worker;
+    for (long v = begin; v < end; ++v) {
+        if (atomic_load_explicit(&state->inDegree[v], memory_order_relaxed) == 0) {
+            local[count++] = (uint32_t)v;
+        }
+    }
+    csrTopoFlush(state, local, count);
+    free(local);
+}
+
+// Helper to remove a slice of the frontier (given as positions in order) from the graph,
+// collecting the vertices whose last incoming edge it removes
+void csrTopoStepSlice(long begin, long end, int worker, void* ctx) {
+    struct CSRTopoState* state = (struct CSRTopoState*)ctx;
+    const struct CSRGraph* csr = state->csr;
+    uint64_t capacity = 256, count = 0;
+    uint32_t* local = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+    (void)worker;
+
+    for (long i = begin; i < end; ++i) {
+        uint32_t u = state->order[i];
+        for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+            uint32_t v = csr->neighbors[e];
+            if (atomic_fetch_sub_explicit(&state->inDegree[v], 1, memory_order_relaxed) == 1) {
+                if (count == capacity) {
+                    capacity *= 2;
+                    local = (uint32_t*)realloc(local, capacity * sizeof(uint32_t));
+                }
+                local[count++] = v;
+            }
+        }
+    }
+
+    csrTopoFlush(state, local, count);
+    free(local);
+}
+
+// Function to topologically sort a directed CSR graph with Kahn's algorithm, removing each
+// in-degree-zero frontier in parallel. Writes the order into order and returns its length.
+// A result shorter than csr->vertices means the graph has a cycle; then, unless cycle is NULL,
+// one cycle's vertices are written to cycle in edge order and their count to *cycleLength.
+uint32_t csrParallelTopologicalSort(const struct CSRGraph* csr, uint32_t* order, uint32_t* cycle,
+                                    uint32_t* cycleLength) {
+    struct CSRTopoState state;
+    int workers = parallel_num_threads();
+    uint64_t head = 0;
+
+    state.csr = csr;
+    state.inDegree = (_Atomic uint32_t*)calloc((size_t)csr->vertices + 1, sizeof(_Atomic uint32_t));
+    state.order = order;
+    atomic_init(&state.tail, 0);
+
+    parallel_for(0, csr->vertices, workers, csrTopoCountSlice, &state);
+    parallel_for(0, csr->vertices, workers, csrTopoSeedSlice, &state);
+
+    // Vertices within one frontier are independent, so any order among them is valid
+    uint64_t tail = atomic_load_explicit(&state.tail, memory_order_relaxed);
+    while (head < tail) {
+        int stepWorkers = tail - head < CSR_TOPO_PARALLEL_CUTOFF ? 1 : workers;
+        parallel_for((long)head, (long)tail, stepWorkers, csrTopoStepSlice, &state);
+        head = tail;
+        tail = atomic_load_explicit(&state.tail, memory_order_relaxed);
+    }
+    free((void*)state.inDegree);
+
+    if (cycle != NULL) {
+        *cycleLength = tail < csr->vertices ? csrFindCycle(csr, cycle) : 0;
+    }
+    return (uint32_t)tail;
+}
+
+// Function to run csrParallelTopologicalSort on an adjacency-list graph; arguments and result
+// are as for the CSR version, with cycle left untouched when the graph is acyclic
+int parallelTopologicalSort(struct Graph* graph, int* order, int* cycle, int* cycleLength) {
+    struct CSRGraph* csr = createCSRFromGraph(graph);
+    uint32_t length = 0;
+    uint32_t sorted = csrParallelTopologicalSort(csr, (uint32_t*)order, (uint32_t*)cycle, &length);
+    if (cycle != NULL) {
+        *cycleLength = (int)length;
+    }
+    freeCSRGraph(csr);
+    return (int)sorted;
+}
+
+#endif
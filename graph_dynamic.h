@@ -0,0 +1,508 @@
+#ifndef GRAPH_DYNAMIC_H
+#define GRAPH_DYNAMIC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "graph_csr.h"
+#include "epoch.h"
+
+// Dynamic graph updated in batches while readers keep querying. Each version is an immutable
+// directory of sorted neighbour arrays, split into chunks of DYNAMIC_CHUNK_SIZE vertices. A batch
+// rebuilds only the arrays of the vertices it touches and the chunks holding them, shares
+// everything else with the previous version, and publishes the result with one atomic store.
+// Readers pin a version through an epoch domain, so replaced arrays are freed only once no
+// reader can still see them. Writers are serialised by writeLock.
+
+// Vertices per directory chunk
+#define DYNAMIC_CHUNK_SHIFT 10
+#define DYNAMIC_CHUNK_SIZE (1u << DYNAMIC_CHUNK_SHIFT)
+
+// Immutable sorted neighbour array of one vertex; vertices without neighbours have none
+struct DynamicList {
+    uint32_t degree;
+    uint32_t neighbors[];
+};
+
+// One published version of the graph
+struct DynamicVersion {
+    uint64_t version;
+    uint64_t edges;
+    uint32_t vertices;
+    uint32_t chunkCount;
+    struct DynamicList*** chunks;  // chunks[v >> DYNAMIC_CHUNK_SHIFT][v & (DYNAMIC_CHUNK_SIZE - 1)]
+};
+
+struct DynamicGraph {
+    struct DynamicVersion* _Atomic current;
+    bool undirected;
+    pthread_mutex_t writeLock;
+    struct EpochDomain epoch;
+};
+
+// Statistics of one applied batch
+struct DynamicBatchStats {
+    uint64_t version;    // Version published by the batch
+    uint64_t inserted;   // Edges that were absent and are now present
+    uint64_t deleted;    // Edges that were present and are now absent
+};
+
+// Memory a batch replaced, freed in one piece once no reader can see it
+struct DynamicGarbage {
+    size_t count;
+    size_t capacity;
+    void** items;
+    struct DynamicVersion* version;  // Replaced version header and directory, or NULL
+};
+
+// Function to create an empty dynamic graph of up to 2^31 vertices, or NULL if vertices is larger;
+// with undirected set every update applies to both directions, like addEdge
+struct DynamicGraph* createDynamicGraph(uint32_t vertices, bool undirected) {
+    // Packed batch keys hold two vertex ids and an op bit in 64 bits
+    if (vertices > (1u << 31)) {
+        return NULL;
+    }
+
+    struct DynamicGraph* graph = (struct DynamicGraph*)malloc(sizeof(struct DynamicGraph));
+    struct DynamicVersion* version = (struct DynamicVersion*)malloc(sizeof(struct DynamicVersion));
+
+    version->version = 0;
+    version->edges = 0;
+    version->vertices = vertices;
+    version->chunkCount = (vertices + DYNAMIC_CHUNK_SIZE - 1) >> DYNAMIC_CHUNK_SHIFT;
+    version->chunks = (struct DynamicList***)malloc((version->chunkCount + 1) * sizeof(struct DynamicList**));
+    for (uint32_t c = 0; c < version->chunkCount; ++c) {
+        version->chunks[c] = (struct DynamicList**)calloc(DYNAMIC_CHUNK_SIZE, sizeof(struct DynamicList*));
+    }
+
+    atomic_init(&graph->current, version);
+    graph->undirected = undirected;
+    pthread_mutex_init(&graph->writeLock, NULL);
+    epoch_domain_init(&graph->epoch);
+    return graph;
+}
+
+// Helper to free a garbage bundle; called by the epoch domain
+void dynamicFreeGarbage(void* ptr) {
+    struct DynamicGarbage* garbage = (struct DynamicGarbage*)ptr;
+    for (size_t i = 0; i < garbage->count; ++i) {
+        free(garbage->items[i]);
+    }
+    if (garbage->version != NULL) {
+        free(garbage->version->chunks);
+        free(garbage->version);
+    }
+    free(garbage->items);
+    free(garbage);
+}
+
+// Helper to queue a replaced allocation for freeing
+void dynamicCollect(struct DynamicGarbage* garbage, void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    if (garbage->count == garbage->capacity) {
+        garbage->capacity = garbage->capacity ? 2 * garbage->capacity : 64;
+        garbage->items = (void**)realloc(garbage->items, garbage->capacity * sizeof(void*));
+    }
+    garbage->items[garbage->count++] = ptr;
+}
+
+// Function to free a dynamic graph; no reader may be active
+void freeDynamicGraph(struct DynamicGraph* graph) {
+    struct DynamicVersion* version = atomic_load(&graph->current);
+    for (uint32_t c = 0; c < version->chunkCount; ++c) {
+        for (uint32_t i = 0; i < DYNAMIC_CHUNK_SIZE; ++i) {
+            free(version->chunks[c][i]);
+        }
+        free(version->chunks[c]);
+    }
+    free(version->chunks);
+    free(version);
+    epoch_domain_destroy(&graph->epoch);
+    pthread_mutex_destroy(&graph->writeLock);
+    free(graph);
+}
+
+// Function to register the calling thread as a reader; returns its reader id
+int dynamicRegisterReader(struct DynamicGraph* graph) {
+    return epoch_register(&graph->epoch);
+}
+
+// Function to release a reader id
+void dynamicUnregisterReader(struct DynamicGraph* graph, int reader) {
+    epoch_unregister(&graph->epoch, reader);
+}
+
+// Function to pin the current version; it stays valid and unchanged until dynamicRelease
+const struct DynamicVersion* dynamicAcquire(struct DynamicGraph* graph, int reader) {
+    epoch_enter(&graph->epoch, reader);
+    return atomic_load_explicit(&graph->current, memory_order_acquire);
+}
+
+// Function to unpin the version acquired by reader
+void dynamicRelease(struct DynamicGraph* graph, int reader) {
+    epoch_exit(&graph->epoch, reader);
+}
+
+// Helper to find the neighbour array of a vertex in a version
+const struct DynamicList* dynamicList(const struct DynamicVersion* version, uint32_t vertex) {
+    return version->chunks[vertex >> DYNAMIC_CHUNK_SHIFT][vertex & (DYNAMIC_CHUNK_SIZE - 1)];
+}
+
+// Function to get the out-degree of a vertex in a version
+uint32_t dynamicDegree(const struct DynamicVersion* version, uint32_t vertex) {
+    const struct DynamicList* list = dynamicList(version, vertex);
+    return list ? list->degree : 0;
+}
+
+// Function to get the sorted neighbours of a vertex in a version; dynamicDegree gives the length
+const uint32_t* dynamicNeighbors(const struct DynamicVersion* version, uint32_t vertex) {
+    const struct DynamicList* list = dynamicList(version, vertex);
+    return list ? list->neighbors : NULL;
+}
+
+// Function to check for an edge in a version by binary search
+bool dynamicHasEdge(const struct DynamicVersion* version, uint32_t src, uint32_t dst) {
+    const struct DynamicList* list = dynamicList(version, src);
+    uint32_t lo = 0, hi = list ? list->degree : 0;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (list->neighbors[mid] < dst) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return list != NULL && lo < list->degree && list->neighbors[lo] == dst;
+}
+
+// Digit width of the radix sort that groups a batch by source
+#define DYNAMIC_RADIX_BITS 11
+#define DYNAMIC_RADIX_SIZE (1u << DYNAMIC_RADIX_BITS)
+
+// A batch is sorted as packed keys src << (idBits + 1) | dst << 1 | insert, so for each source the
+// updates come out ordered by destination, deletes before inserts
+uint64_t dynamicPack(uint32_t src, uint32_t dst, bool insert, int idBits) {
+    return (uint64_t)src << (idBits + 1) | (uint64_t)dst << 1 | (insert ? 1 : 0);
+}
+
+// Shared state of the parallel radix sort; each worker sorts one block of keys
+struct DynamicSort {
+    uint64_t* keys;
+    uint64_t* scratch;
+    uint64_t count;
+    int shift;            // Lowest bit of the digit being sorted
+    int blocks;
+    uint64_t* histogram;  // Per block: digit counts, then write positions
+};
+
+// Helper to count the digits of a block of keys
+void dynamicHistogramSlice(long begin, long end, int worker, void* ctx) {
+    struct DynamicSort* sort = (struct DynamicSort*)ctx;
+    (void)worker;
+    for (long b = begin; b < end; ++b) {
+        uint64_t* histogram = sort->histogram + (size_t)b * DYNAMIC_RADIX_SIZE;
+        memset(histogram, 0, DYNAMIC_RADIX_SIZE * sizeof(uint64_t));
+        for (uint64_t i = sort->count * b / sort->blocks; i < sort->count * (b + 1) / sort->blocks; ++i) {
+            histogram[(sort->keys[i] >> sort->shift) & (DYNAMIC_RADIX_SIZE - 1)]++;
+        }
+    }
+}
+
+// Helper to move a block of keys to their positions for the current digit
+void dynamicRadixScatterSlice(long begin, long end, int worker, void* ctx) {
+    struct DynamicSort* sort = (struct DynamicSort*)ctx;
+    (void)worker;
+    for (long b = begin; b < end; ++b) {
+        uint64_t* position = sort->histogram + (size_t)b * DYNAMIC_RADIX_SIZE;
+        for (uint64_t i = sort->count * b / sort->blocks; i < sort->count * (b + 1) / sort->blocks; ++i) {
+            uint64_t key = sort->keys[i];
+            sort->scratch[position[(key >> sort->shift) & (DYNAMIC_RADIX_SIZE - 1)]++] = key;
+        }
+    }
+}
+
+// Helper to sort keys on their low bits with a parallel LSD radix sort; returns the sorted array,
+// which is either keys or scratch
+uint64_t* dynamicRadixSort(uint64_t* keys, uint64_t* scratch, uint64_t count, int bits, int workers) {
+    struct DynamicSort sort = { keys, scratch, count, 0, workers, NULL };
+    sort.histogram = (uint64_t*)malloc((size_t)workers * DYNAMIC_RADIX_SIZE * sizeof(uint64_t));
+
+    for (sort.shift = 0; sort.shift < bits; sort.shift += DYNAMIC_RADIX_BITS) {
+        parallel_for(0, workers, workers, dynamicHistogramSlice, &sort);
+        // Digit-major prefix sum keeps the sort stable across blocks
+        uint64_t running = 0;
+        for (uint32_t d = 0; d < DYNAMIC_RADIX_SIZE; ++d) {
+            for (int b = 0; b < workers; ++b) {
+                uint64_t digits = sort.histogram[(size_t)b * DYNAMIC_RADIX_SIZE + d];
+                sort.histogram[(size_t)b * DYNAMIC_RADIX_SIZE + d] = running;
+                running += digits;
+            }
+        }
+        parallel_for(0, workers, workers, dynamicRadixScatterSlice, &sort);
+
+        uint64_t* swap = sort.keys;
+        sort.keys = sort.scratch;
+        sort.scratch = swap;
+    }
+
+    free(sort.histogram);
+    return sort.keys;
+}
+
+// Helper to find the first key not below key in a sorted array
+uint64_t dynamicLowerBound(const uint64_t* keys, uint64_t count, uint64_t key) {
+    uint64_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (keys[mid] < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Shared state of one batch
+struct DynamicBatch {
+    const struct DynamicVersion* old;
+    struct DynamicVersion* next;
+    const uint64_t* updates;           // Sorted packed updates
+    uint64_t count;
+    int idBits;
+    struct DynamicGarbage** garbage;   // Per worker: replaced chunks and arrays
+    uint64_t* workerInserted;
+    uint64_t* workerDeleted;
+};
+
+// Helper to merge a neighbour array with the sorted packed updates of its vertex. Writes the
+// result to out unless NULL and returns its length; counts the effective changes.
+uint32_t dynamicMerge(const struct DynamicList* list, const uint64_t* updates, uint64_t count, int idBits,
+                      uint32_t* out, uint64_t* inserted, uint64_t* deleted) {
+    uint64_t mask = (1ull << idBits) - 1;
+    uint32_t degree = list ? list->degree : 0, length = 0;
+    uint64_t i = 0, k = 0;
+
+    while (i < degree || k < count) {
+        uint32_t x = i < degree ? list->neighbors[i] : UINT32_MAX;
+        if (k < count && ((updates[k] >> 1) & mask) < x) {
+            x = (uint32_t)((updates[k] >> 1) & mask);
+        }
+        bool present = i < degree && list->neighbors[i] == x;
+        bool insert = false, remove = false;
+        i += present;
+        for (; k < count && ((updates[k] >> 1) & mask) == x; ++k) {
+            if (updates[k] & 1) {
+                insert = true;
+            } else {
+                remove = true;
+            }
+        }
+
+        bool kept = insert || (present && !remove);
+        if (kept) {
+            if (out) {
+                out[length] = x;
+            }
+            length++;
+        }
+        if (present && !kept) {
+            (*deleted)++;
+        } else if (!present && kept) {
+            (*inserted)++;
+        }
+    }
+    return length;
+}
+
+// Helper to rebuild the touched chunks of a slice of chunk indexes
+void dynamicRebuildSlice(long begin, long end, int worker, void* ctx) {
+    struct DynamicBatch* batch = (struct DynamicBatch*)ctx;
+    struct DynamicGarbage* garbage = batch->garbage[worker];
+    int shift = batch->idBits + 1;
+    uint64_t inserted = 0, deleted = 0;
+
+    for (long c = begin; c < end; ++c) {
+        uint64_t first = (uint64_t)c << DYNAMIC_CHUNK_SHIFT;
+        uint64_t k = dynamicLowerBound(batch->updates, batch->count, first << shift);
+        uint64_t stop = dynamicLowerBound(batch->updates, batch->count, (first + DYNAMIC_CHUNK_SIZE) << shift);
+        if (k == stop) {
+            continue;
+        }
+
+        // Copy the chunk's directory, then rebuild the arrays of the vertices the batch touches
+        struct DynamicList** oldChunk = batch->old->chunks[c];
+        struct DynamicList** chunk = (struct DynamicList**)malloc(DYNAMIC_CHUNK_SIZE * sizeof(struct DynamicList*));
+        memcpy(chunk, oldChunk, DYNAMIC_CHUNK_SIZE * sizeof(struct DynamicList*));
+        dynamicCollect(garbage, oldChunk);
+
+        while (k < stop) {
+            uint32_t v = (uint32_t)(batch->updates[k] >> shift);
+            uint64_t group = k;
+            for (; group < stop && (batch->updates[group] >> shift) == v; ++group) {
+            }
+
+            struct DynamicList* list = oldChunk[v - first];
+            uint64_t ignored = 0;
+            uint32_t degree = dynamicMerge(list, batch->updates + k, group - k, batch->idBits, NULL, &ignored, &ignored);
+            struct DynamicList* merged = NULL;
+            if (degree > 0) {
+                merged = (struct DynamicList*)malloc(sizeof(struct DynamicList) + degree * sizeof(uint32_t));
+                merged->degree = degree;
+            }
+            dynamicMerge(list, batch->updates + k, group - k, batch->idBits, merged ? merged->neighbors : NULL,
+                         &inserted, &deleted);
+            chunk[v - first] = merged;
+            dynamicCollect(garbage, list);
+            k = group;
+        }
+        batch->next->chunks[c] = chunk;
+    }
+    batch->workerInserted[worker] = inserted;
+    batch->workerDeleted[worker] = deleted;
+}
+
+// Function to apply a batch of edge inserts and deletes as one new version, using all cores.
+// Deletes apply before inserts; inserting a present edge or deleting an absent one does nothing.
+// Readers keep seeing the previous version until the batch is published. Returns false without
+// changing the graph if any vertex id is out of range. stats may be NULL.
+bool dynamicApplyBatch(struct DynamicGraph* graph, const uint32_t* insSrc, const uint32_t* insDst, uint64_t insCount,
+                       const uint32_t* delSrc, const uint32_t* delDst, uint64_t delCount,
+                       struct DynamicBatchStats* stats) {
+    int workers = parallel_num_threads();
+    uint64_t total = (insCount + delCount) * (graph->undirected ? 2 : 1), count = 0;
+    uint64_t* keys = (uint64_t*)malloc((total > 0 ? total : 1) * sizeof(uint64_t));
+    uint64_t* scratch = (uint64_t*)malloc((total > 0 ? total : 1) * sizeof(uint64_t));
+
+    pthread_mutex_lock(&graph->writeLock);
+    struct DynamicVersion* old = atomic_load_explicit(&graph->current, memory_order_relaxed);
+    int idBits = 1;
+    while ((1ull << idBits) < old->vertices) {
+        idBits++;
+    }
+
+    for (uint64_t i = 0; i < insCount + delCount; ++i) {
+        bool insert = i < insCount;
+        uint32_t u = insert ? insSrc[i] : delSrc[i - insCount];
+        uint32_t v = insert ? insDst[i] : delDst[i - insCount];
+        if (u >= old->vertices || v >= old->vertices) {
+            pthread_mutex_unlock(&graph->writeLock);
+            free(keys);
+            free(scratch);
+            return false;
+        }
+        keys[count++] = dynamicPack(u, v, insert, idBits);
+        if (graph->undirected) {
+            keys[count++] = dynamicPack(v, u, insert, idBits);
+        }
+    }
+    uint64_t* updates = dynamicRadixSort(keys, scratch, count, 2 * idBits + 1, workers);
+
+    struct DynamicVersion* next = (struct DynamicVersion*)malloc(sizeof(struct DynamicVersion));
+    *next = *old;
+    next->version = old->version + 1;
+    next->chunks = (struct DynamicList***)malloc((old->chunkCount + 1) * sizeof(struct DynamicList**));
+    memcpy(next->chunks, old->chunks, old->chunkCount * sizeof(struct DynamicList**));
+
+    struct DynamicBatch batch = { old, next, updates, count, idBits, NULL, NULL, NULL };
+    batch.garbage = (struct DynamicGarbage**)malloc(workers * sizeof(struct DynamicGarbage*));
+    batch.workerInserted = (uint64_t*)calloc(workers, sizeof(uint64_t));
+    batch.workerDeleted = (uint64_t*)calloc(workers, sizeof(uint64_t));
+    for (int w = 0; w < workers; ++w) {
+        batch.garbage[w] = (struct DynamicGarbage*)calloc(1, sizeof(struct DynamicGarbage));
+    }
+    parallel_for(0, old->chunkCount, workers, dynamicRebuildSlice, &batch);
+
+    uint64_t inserted = 0, deleted = 0;
+    for (int w = 0; w < workers; ++w) {
+        inserted += batch.workerInserted[w];
+        deleted += batch.workerDeleted[w];
+    }
+    next->edges = old->edges + inserted - deleted;
+    atomic_store_explicit(&graph->current, next, memory_order_release);
+
+    // Everything the old version owned alone goes in one bundle
+    struct DynamicGarbage* garbage = batch.garbage[0];
+    for (int w = 1; w < workers; ++w) {
+        for (size_t i = 0; i < batch.garbage[w]->count; ++i) {
+            dynamicCollect(garbage, batch.garbage[w]->items[i]);
+        }
+        free(batch.garbage[w]->items);
+        free(batch.garbage[w]);
+    }
+    garbage->version = old;
+    epoch_retire(&graph->epoch, garbage, dynamicFreeGarbage);
+    // One bundle can hold a whole version's worth of arrays, so free old ones every batch instead
+    // of waiting for EPOCH_RECLAIM_THRESHOLD bundles to pile up
+    epoch_reclaim(&graph->epoch);
+    pthread_mutex_unlock(&graph->writeLock);
+
+    if (stats != NULL) {
+        stats->version = next->version;
+        stats->inserted = inserted;
+        stats->deleted = deleted;
+    }
+
+    free(keys);
+    free(scratch);
+    free(batch.garbage);
+    free(batch.workerInserted);
+    free(batch.workerDeleted);
+    return true;
+}
+
+// Function to copy a version into a CSR graph, e.g. to run the parallel kernels on it
+struct CSRGraph* dynamicToCSR(const struct DynamicVersion* version) {
+    struct CSRGraph* csr = createCSRGraph(version->vertices, version->edges);
+    uint64_t running = 0;
+    for (uint32_t v = 0; v < version->vertices; ++v) {
+        const struct DynamicList* list = dynamicList(version, v);
+        csr->offsets[v] = running;
+        if (list != NULL) {
+            memcpy(csr->neighbors + running, list->neighbors, list->degree * sizeof(uint32_t));
+            running += list->degree;
+        }
+    }
+    csr->offsets[version->vertices] = running;
+    return csr;
+}
+
+// Function to run a BFS on the current version from start; level[v] receives the distance from
+// start or -1 if unreached. Concurrent batches do not affect the result. Returns the number of
+// vertices reached.
+uint32_t dynamicBfs(struct DynamicGraph* graph, int reader, uint32_t start, int* level) {
+    const struct DynamicVersion* version = dynamicAcquire(graph, reader);
+    uint32_t* queue = (uint32_t*)malloc(((size_t)version->vertices + 1) * sizeof(uint32_t));
+    uint32_t head = 0, tail = 0;
+
+    for (uint32_t v = 0; v < version->vertices; ++v) {
+        level[v] = -1;
+    }
+    if (start < version->vertices) {
+        level[start] = 0;
+        queue[tail++] = start;
+    }
+    while (head < tail) {
+        uint32_t u = queue[head++];
+        const struct DynamicList* list = dynamicList(version, u);
+        for (uint32_t i = 0; list != NULL && i < list->degree; ++i) {
+            uint32_t v = list->neighbors[i];
+            if (level[v] < 0) {
+                level[v] = level[u] + 1;
+                queue[tail++] = v;
+            }
+        }
+    }
+
+    dynamicRelease(graph, reader);
+    free(queue);
+    return tail;
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "graph_dynamic.h"
+
+// Regression driver for graph_dynamic.h. Build with
+//   gcc -std=c11 -O2 graph_dynamic_test.c -pthread -o graph_dynamic_test
+// It checks batches against a reference matrix, then runs many batches with no reader
+// registered and fails if resident memory keeps growing while the graph size stays flat.
+// Under AddressSanitizer set ASAN_OPTIONS=quarantine_size_mb=0, or its quarantine of freed
+// memory shows up as growth.
+
+#define TEST_VERTICES 50000
+#define TEST_BATCH 50000
+#define TEST_BATCHES 300
+
+// Helper for a small deterministic random generator
+uint32_t testRandom(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return (uint32_t)(*state >> 32);
+}
+
+// Helper to read the resident set size in kilobytes, or 0 if unknown
+long residentKilobytes(void) {
+    long pages = 0, resident = 0;
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (file == NULL) {
+        return 0;
+    }
+    if (fscanf(file, "%ld %ld", &pages, &resident) != 2) {
+        resident = 0;
+    }
+    fclose(file);
+    return resident * 4;
+}
+
+// Function to compare random batches with an adjacency matrix
+bool testAgainstMatrix(bool undirected) {
+    uint32_t n = 200, src[400], dst[400], delSrc[400], delDst[400];
+    uint64_t state = 88172645463325252ull;
+    bool* matrix = (bool*)calloc(n * n, sizeof(bool));
+    struct DynamicGraph* graph = createDynamicGraph(n, undirected);
+    int reader = dynamicRegisterReader(graph);
+    bool ok = true;
+
+    for (int b = 0; b < 50 && ok; ++b) {
+        for (int i = 0; i < 400; ++i) {
+            src[i] = testRandom(&state) % n;
+            dst[i] = testRandom(&state) % n;
+            delSrc[i] = testRandom(&state) % n;
+            delDst[i] = testRandom(&state) % n;
+        }
+        // The version pinned here must not change while the batch is applied
+        const struct DynamicVersion* old = dynamicAcquire(graph, reader);
+        uint64_t oldEdges = old->edges;
+        dynamicApplyBatch(graph, src, dst, 400, delSrc, delDst, 400, NULL);
+        ok = old->edges == oldEdges;
+        dynamicRelease(graph, reader);
+
+        for (int i = 0; i < 400; ++i) {
+            matrix[delSrc[i] * n + delDst[i]] = false;
+            if (undirected) {
+                matrix[delDst[i] * n + delSrc[i]] = false;
+            }
+        }
+        for (int i = 0; i < 400; ++i) {
+            matrix[src[i] * n + dst[i]] = true;
+            if (undirected) {
+                matrix[dst[i] * n + src[i]] = true;
+            }
+        }
+
+        const struct DynamicVersion* version = dynamicAcquire(graph, reader);
+        uint64_t edges = 0;
+        for (uint32_t u = 0; u < n; ++u) {
+            for (uint32_t v = 0; v < n; ++v) {
+                ok = ok && matrix[u * n + v] == dynamicHasEdge(version, u, v);
+                edges += matrix[u * n + v];
+            }
+        }
+        ok = ok && edges == version->edges;
+        dynamicRelease(graph, reader);
+    }
+
+    dynamicUnregisterReader(graph, reader);
+    freeDynamicGraph(graph);
+    free(matrix);
+    return ok;
+}
+
+// Function to check that replaced arrays are freed when nobody reads: every batch inserts a fresh
+// set of edges and deletes the previous one, so the live graph stays the same size
+bool testMemoryBounded(void) {
+    struct DynamicGraph* graph = createDynamicGraph(TEST_VERTICES, false);
+    uint32_t* src[2], * dst[2];
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    long settled = 0, peak = 0;
+
+    for (int k = 0; k < 2; ++k) {
+        src[k] = (uint32_t*)malloc(TEST_BATCH * sizeof(uint32_t));
+        dst[k] = (uint32_t*)malloc(TEST_BATCH * sizeof(uint32_t));
+    }
+    for (int b = 0; b < TEST_BATCHES; ++b) {
+        uint32_t* insSrc = src[b % 2], * insDst = dst[b % 2];
+        for (int i = 0; i < TEST_BATCH; ++i) {
+            insSrc[i] = testRandom(&state) % TEST_VERTICES;
+            insDst[i] = testRandom(&state) % TEST_VERTICES;
+        }
+        dynamicApplyBatch(graph, insSrc, insDst, TEST_BATCH, src[(b + 1) % 2], dst[(b + 1) % 2],
+                          b > 0 ? TEST_BATCH : 0, NULL);
+
+        long resident = residentKilobytes();
+        if (b == 20) {
+            settled = resident;
+        }
+        peak = resident > peak ? resident : peak;
+    }
+    printf("Resident memory after 20 batches: %ld KB, peak over %d batches: %ld KB\n",
+           settled, TEST_BATCHES, peak);
+
+    for (int k = 0; k < 2; ++k) {
+        free(src[k]);
+        free(dst[k]);
+    }
+    freeDynamicGraph(graph);
+    return peak <= 2 * settled + 16384;
+}
+
+int main() {
+    bool ok = true;
+
+    if (createDynamicGraph(UINT32_MAX, false) != NULL) {
+        printf("FAIL: oversized graph accepted\n");
+        ok = false;
+    }
+    for (int undirected = 0; undirected < 2; ++undirected) {
+        if (!testAgainstMatrix(undirected)) {
+            printf("FAIL: batches disagree with the reference (undirected %d)\n", undirected);
+            ok = false;
+        }
+    }
+    if (!testMemoryBounded()) {
+        printf("FAIL: resident memory grows without readers\n");
+        ok = false;
+    }
+
+    printf(ok ? "All dynamic graph tests passed\n" : "Dynamic graph tests failed\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,390 @@
+#ifndef GRAPH_IO_H
+#define GRAPH_IO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "graph_csr.h"
+
+// Loading and saving CSR graphs. Text edge lists ("src dst" per line, extra columns ignored,
+// lines starting with '#' or '%' skipped) are mapped and parsed by all cores. The binary format
+// is a fixed header followed by the offset and neighbour arrays, and can be used in place
+// through mmap.
+
+#define GRAPH_BINARY_MAGIC "GRAPHCSR"
+#define GRAPH_BINARY_VERSION 1u
+
+struct GraphBinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t idSize;   // Bytes per neighbour id
+    uint64_t vertices;
+    uint64_t edges;
+};
+
+// Edge list parsed from a text file
+struct EdgeList {
+    uint32_t vertices;  // Largest id seen plus one
+    uint64_t count;
+    uint32_t* src;
+    uint32_t* dst;
+};
+
+// File contents held in memory, mapped when possible
+struct GraphFile {
+    void* base;
+    size_t length;
+    bool mapped;
+};
+
+// CSR graph opened from a binary file; graph.offsets and graph.neighbors point into the file
+struct MappedCSRGraph {
+    struct CSRGraph graph;
+    struct GraphFile file;
+};
+
+// Function to map a whole file read-only, reading it into memory if mapping fails
+bool openGraphFile(struct GraphFile* file, const char* path) {
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    file->length = (size_t)st.st_size;
+    file->base = file->length > 0 ? mmap(NULL, file->length, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    file->mapped = file->base != MAP_FAILED;
+    if (!file->mapped) {
+        file->base = malloc(file->length > 0 ? file->length : 1);
+        size_t done = 0;
+        while (file->base != NULL && done < file->length) {
+            ssize_t got = read(fd, (char*)file->base + done, file->length - done);
+            if (got <= 0) {
+                free(file->base);
+                file->base = NULL;
+            } else {
+                done += (size_t)got;
+            }
+        }
+    }
+    close(fd);
+    return file->base != NULL;
+}
+
+// Function to release a file opened with openGraphFile
+void closeGraphFile(struct GraphFile* file) {
+    if (file->base != NULL) {
+        if (file->mapped) {
+            munmap(file->base, file->length);
+        } else {
+            free(file->base);
+        }
+    }
+    file->base = NULL;
+    file->length = 0;
+}
+
+// Shared state of one parallel text parse
+struct EdgeListParse {
+    const char* text;
+    size_t length;
+    size_t* chunkStart;      // Byte range of chunk w is [chunkStart[w], chunkStart[w + 1])
+    uint64_t* chunkOffset;   // First edge slot reserved for chunk w
+    uint64_t* chunkCount;    // Edges actually parsed by chunk w
+    uint32_t* chunkMax;      // Largest id parsed by chunk w
+    uint32_t* src;
+    uint32_t* dst;
+    atomic_bool failed;
+};
+
+// Helper to parse an unsigned id at *pos, skipping blanks first; returns false if there is none
+bool parseVertexId(const char* text, size_t end, size_t* pos, uint32_t* id) {
+    size_t i = *pos;
+    while (i < end && (text[i] == ' ' || text[i] == '\t' || text[i] == ',')) {
+        i++;
+    }
+    if (i == end || (unsigned)(text[i] - '0') > 9) {
+        return false;
+    }
+
+    uint64_t value = 0;
+    while (i < end && (unsigned)(text[i] - '0') <= 9) {
+        value = value * 10 + (uint64_t)(text[i] - '0');
+        if (value >= UINT32_MAX) {
+            return false;
+        }
+        i++;
+    }
+    *id = (uint32_t)value;
+    *pos = i;
+    return true;
+}
+
+// Helper to count the lines of each chunk in a slice, an upper bound on its edges
+void edgeListCountSlice(long begin, long end, int worker, void* ctx) {
+    struct EdgeListParse* parse = (struct EdgeListParse*)ctx;
+    (void)worker;
+    for (long c = begin; c < end; ++c) {
+        const char* at = parse->text + parse->chunkStart[c];
+        const char* stop = parse->text + parse->chunkStart[c + 1];
+        uint64_t lines = 0;
+        while (at < stop && (at = (const char*)memchr(at, '\n', (size_t)(stop - at))) != NULL) {
+            lines++;
+            at++;
+        }
+        parse->chunkCount[c] = lines + 1;
+    }
+}
+
+// Helper to parse the edges of one chunk into its reserved slots
+void edgeListParseChunk(struct EdgeListParse* parse, long chunk) {
+    const char* text = parse->text;
+    size_t pos = parse->chunkStart[chunk], stop = parse->chunkStart[chunk + 1];
+    uint64_t out = parse->chunkOffset[chunk];
+    uint32_t maxId = 0;
+
+    while (pos < stop) {
+        const char* newline = (const char*)memchr(text + pos, '\n', stop - pos);
+        size_t lineEnd = newline ? (size_t)(newline - text) : stop;
+        size_t i = pos;
+        uint32_t u, v;
+
+        while (i < lineEnd && (text[i] == ' ' || text[i] == '\t' || text[i] == '\r')) {
+            i++;
+        }
+        if (i < lineEnd && text[i] != '#' && text[i] != '%') {
+            if (!parseVertexId(text, lineEnd, &i, &u) || !parseVertexId(text, lineEnd, &i, &v)) {
+                atomic_store(&parse->failed, true);
+                return;
+            }
+            parse->src[out] = u;
+            parse->dst[out] = v;
+            out++;
+            maxId = u > maxId ? u : maxId;
+            maxId = v > maxId ? v : maxId;
+        }
+        pos = lineEnd + 1;
+    }
+
+    parse->chunkCount[chunk] = out - parse->chunkOffset[chunk];
+    parse->chunkMax[chunk] = maxId;
+}
+
+// Helper to parse each chunk in a slice
+void edgeListParseSlice(long begin, long end, int worker, void* ctx) {
+    (void)worker;
+    for (long c = begin; c < end; ++c) {
+        edgeListParseChunk((struct EdgeListParse*)ctx, c);
+    }
+}
+
+// Function to parse a text edge list with all cores; returns false if the file cannot be read
+// or a line is malformed
+bool loadEdgeList(const char* path, struct EdgeList* edges) {
+    struct GraphFile file;
+    if (!openGraphFile(&file, path)) {
+        return false;
+    }
+
+    struct EdgeListParse parse;
+    int chunks = parallel_num_threads();
+    parse.text = (const char*)file.base;
+    parse.length = file.length;
+    parse.chunkStart = (size_t*)malloc((chunks + 1) * sizeof(size_t));
+    parse.chunkOffset = (uint64_t*)malloc(chunks * sizeof(uint64_t));
+    parse.chunkCount = (uint64_t*)malloc(chunks * sizeof(uint64_t));
+    parse.chunkMax = (uint32_t*)calloc(chunks, sizeof(uint32_t));
+    atomic_init(&parse.failed, false);
+
+    // Chunk boundaries sit just after a newline so no line is split
+    parse.chunkStart[0] = 0;
+    for (int w = 1; w < chunks; ++w) {
+        size_t at = file.length * w / chunks;
+        if (at < parse.chunkStart[w - 1]) {
+            at = parse.chunkStart[w - 1];
+        }
+        while (at > 0 && at < file.length && parse.text[at - 1] != '\n') {
+            at++;
+        }
+        parse.chunkStart[w] = at;
+    }
+    parse.chunkStart[chunks] = file.length;
+
+    // Reserve one slot per line, parse in place, then close the gaps left by comments
+    parallel_for(0, chunks, chunks, edgeListCountSlice, &parse);
+    uint64_t slots = 0;
+    for (int w = 0; w < chunks; ++w) {
+        parse.chunkOffset[w] = slots;
+        slots += parse.chunkCount[w];
+    }
+    parse.src = (uint32_t*)malloc(slots * sizeof(uint32_t));
+    parse.dst = (uint32_t*)malloc(slots * sizeof(uint32_t));
+    parallel_for(0, chunks, chunks, edgeListParseSlice, &parse);
+
+    bool ok = !atomic_load(&parse.failed);
+    edges->count = 0;
+    edges->vertices = 0;
+    for (int w = 0; ok && w < chunks; ++w) {
+        memmove(parse.src + edges->count, parse.src + parse.chunkOffset[w], parse.chunkCount[w] * sizeof(uint32_t));
+        memmove(parse.dst + edges->count, parse.dst + parse.chunkOffset[w], parse.chunkCount[w] * sizeof(uint32_t));
+        edges->count += parse.chunkCount[w];
+        if (parse.chunkCount[w] > 0 && parse.chunkMax[w] + 1 > edges->vertices) {
+            edges->vertices = parse.chunkMax[w] + 1;
+        }
+    }
+    edges->src = parse.src;
+    edges->dst = parse.dst;
+    if (!ok) {
+        free(parse.src);
+        free(parse.dst);
+        edges->src = edges->dst = NULL;
+    }
+
+    free(parse.chunkStart);
+    free(parse.chunkOffset);
+    free(parse.chunkCount);
+    free(parse.chunkMax);
+    closeGraphFile(&file);
+    return ok;
+}
+
+// Function to free the arrays of an edge list
+void freeEdgeList(struct EdgeList* edges) {
+    free(edges->src);
+    free(edges->dst);
+    edges->src = edges->dst = NULL;
+    edges->count = 0;
+}
+
+// Function to load a text edge list straight into a CSR graph; returns NULL on error
+struct CSRGraph* loadCSRFromEdgeList(const char* path, bool undirected) {
+    struct EdgeList edges;
+    if (!loadEdgeList(path, &edges)) {
+        return NULL;
+    }
+    struct CSRGraph* csr = createCSRFromEdges(edges.vertices, edges.src, edges.dst, edges.count, undirected);
+    freeEdgeList(&edges);
+    return csr;
+}
+
+// Function to write a CSR graph as a text edge list, one "src dst" line per stored edge
+bool saveEdgeList(const struct CSRGraph* csr, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    bool ok = true;
+    for (uint32_t u = 0; ok && u < csr->vertices; ++u) {
+        for (uint64_t e = csr->offsets[u]; ok && e < csr->offsets[u + 1]; ++e) {
+            ok = fprintf(file, "%u %u\n", u, csr->neighbors[e]) > 0;
+        }
+    }
+    return fclose(file) == 0 && ok;
+}
+
+// Function to write a CSR graph in the binary format; edge weights are not stored
+bool saveCSRBinary(const struct CSRGraph* csr, const char* path) {
+    struct GraphBinaryHeader header;
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_BINARY_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_BINARY_VERSION;
+    header.idSize = sizeof(uint32_t);
+    header.vertices = csr->vertices;
+    header.edges = csr->edges;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(csr->offsets, sizeof(uint64_t), (size_t)csr->vertices + 1, file) == (size_t)csr->vertices + 1 &&
+              fwrite(csr->neighbors, sizeof(uint32_t), csr->edges, file) == csr->edges;
+    return fclose(file) == 0 && ok;
+}
+
+// Function to open a binary CSR graph in place. Only the header is checked unless verify is
+// set, which also checks every offset and neighbour id in O(V + E).
+bool openCSRBinary(struct MappedCSRGraph* mapped, const char* path, bool verify) {
+    if (!openGraphFile(&mapped->file, path)) {
+        return false;
+    }
+
+    const struct GraphBinaryHeader* header = (const struct GraphBinaryHeader*)mapped->file.base;
+    size_t length = mapped->file.length;
+    bool ok = length >= sizeof(*header) &&
+              memcmp(header->magic, GRAPH_BINARY_MAGIC, sizeof(header->magic)) == 0 &&
+              header->version == GRAPH_BINARY_VERSION &&
+              header->idSize == sizeof(uint32_t) &&
+              header->vertices < UINT32_MAX;
+
+    // Bound both counts by the file size before multiplying, so a crafted header cannot wrap the length check
+    size_t payload = ok ? length - sizeof(*header) : 0;
+    ok = ok && header->vertices + 1 <= payload / sizeof(uint64_t);
+    size_t offsetBytes = ok ? (size_t)(header->vertices + 1) * sizeof(uint64_t) : 0;
+    ok = ok && header->edges <= (payload - offsetBytes) / sizeof(uint32_t) &&
+         payload == offsetBytes + header->edges * sizeof(uint32_t);
+
+    if (ok) {
+        // The CSR arrays are only read, so pointing them into the read-only file is safe
+        mapped->graph.vertices = (uint32_t)header->vertices;
+        mapped->graph.edges = header->edges;
+        mapped->graph.offsets = (uint64_t*)(header + 1);
+        mapped->graph.neighbors = (uint32_t*)(mapped->graph.offsets + header->vertices + 1);
+        mapped->graph.weights = NULL;
+        ok = mapped->graph.offsets[0] == 0 && mapped->graph.offsets[header->vertices] == header->edges;
+    }
+    for (uint32_t v = 0; ok && verify && v < mapped->graph.vertices; ++v) {
+        ok = mapped->graph.offsets[v] <= mapped->graph.offsets[v + 1];
+    }
+    for (uint64_t e = 0; ok && verify && e < mapped->graph.edges; ++e) {
+        ok = mapped->graph.neighbors[e] < mapped->graph.vertices;
+    }
+
+    if (!ok) {
+        closeGraphFile(&mapped->file);
+    }
+    return ok;
+}
+
+// Function to release a graph opened with openCSRBinary
+void closeCSRBinary(struct MappedCSRGraph* mapped) {
+    closeGraphFile(&mapped->file);
+    memset(&mapped->graph, 0, sizeof(mapped->graph));
+}
+
+// Function to convert a text edge list into the binary format
+bool convertEdgeListToBinary(const char* textPath, const char* binaryPath, bool undirected) {
+    struct CSRGraph* csr = loadCSRFromEdgeList(textPath, undirected);
+    if (csr == NULL) {
+        return false;
+    }
+    bool ok = saveCSRBinary(csr, binaryPath);
+    freeCSRGraph(csr);
+    return ok;
+}
+
+// Function to convert a binary graph back into a text edge list
+bool convertBinaryToEdgeList(const char* binaryPath, const char* textPath) {
+    struct MappedCSRGraph mapped;
+    if (!openCSRBinary(&mapped, binaryPath, false)) {
+        return false;
+    }
+    bool ok = saveEdgeList(&mapped.graph, textPath);
+    closeCSRBinary(&mapped);
+    return ok;
+}
+
+#endif
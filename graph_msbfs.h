@@ -0,0 +1,319 @@
+#ifndef GRAPH_MSBFS_H
+#define GRAPH_MSBFS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "graph_csr.h"
+
+// Multi-source BFS (Then et al., "The More the Merrier"). Up to MSBFS_MAX_SOURCES traversals
+// run together, each owning one bit of a few 64-bit words per vertex, so one scan of an edge
+// advances every traversal in the batch. Like csrParallelBfs, each level either pushes the
+// frontier bits along out-edges (top-down, for small frontiers) or pulls them from in-neighbours
+// (bottom-up, which needs no atomics).
+
+// Largest batch run at once (8 words per vertex); bigger requests are split into batches
+#define MSBFS_MAX_SOURCES 512
+
+// Aggregate result of one source's traversal
+struct MSBFSStats {
+    uint32_t reached;      // Vertices reached, including the source
+    uint64_t distanceSum;  // Sum of the distances to every reached vertex
+    uint32_t eccentricity; // Largest distance to a reached vertex
+};
+
+// Growable list of vertices a worker put in the next frontier
+struct MSBFSList {
+    uint32_t* items;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+// Shared state of one batch
+struct MSBFSState {
+    const struct CSRGraph* csr;
+    const struct CSRGraph* incoming;
+    int words;             // 64-bit words per vertex
+    int count;             // Sources in this batch
+    uint32_t level;        // Level being discovered
+    uint64_t full[MSBFS_MAX_SOURCES / 64];  // Bits of traversals that exist in this batch
+    uint64_t* seen;        // Traversals that have reached each vertex
+    uint64_t* visit;       // Traversals whose frontier holds each vertex
+    _Atomic uint64_t* visitNext;
+    _Atomic bool* claimed; // Vertices already listed for the next frontier by the top-down step
+    uint32_t* frontier;    // Vertices with visit bits set
+    uint32_t frontierSize;
+    struct MSBFSList* lists;
+    uint64_t* found;       // Per worker: vertices each traversal reached at this level
+    int* distances;        // Source-major distance arrays, or NULL
+    uint32_t vertices;
+};
+
+// Helper to append a vertex to a worker's next-frontier list
+void msbfsListPush(struct MSBFSList* list, uint32_t v) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? 2 * list->capacity : 256;
+        list->items = (uint32_t*)realloc(list->items, list->capacity * sizeof(uint32_t));
+    }
+    list->items[list->count++] = v;
+}
+
+// Helper to record the traversals in fresh (word k) as having reached v at this level
+void msbfsRecord(struct MSBFSState* state, uint64_t* found, uint32_t v, int k, uint64_t fresh) {
+    for (; fresh; fresh &= fresh - 1) {
+        int source = 64 * k + __builtin_ctzll(fresh);
+        found[source]++;
+        if (state->distances) {
+            state->distances[(size_t)source * state->vertices + v] = (int)state->level;
+        }
+    }
+}
+
+// Helper for a bottom-up level over a slice of vertices: collect the frontier bits of the
+// in-neighbours and keep those of traversals that had not reached the vertex yet
+void msbfsPullSlice(long begin, long end, int worker, void* ctx) {
+    struct MSBFSState* state = (struct MSBFSState*)ctx;
+    const struct CSRGraph* incoming = state->incoming;
+    int words = state->words;
+    uint64_t* found = state->found + (size_t)worker * state->count;
+    uint64_t pending[MSBFS_MAX_SOURCES / 64];
+
+    for (long v = begin; v < end; ++v) {
+        uint64_t* seen = state->seen + (size_t)v * words;
+        _Atomic uint64_t* next = state->visitNext + (size_t)v * words;
+        uint64_t gathered[MSBFS_MAX_SOURCES / 64];
+        bool any = false;
+        for (int k = 0; k < words; ++k) {
+            pending[k] = state->full[k] & ~seen[k];
+            gathered[k] = 0;
+            any = any || pending[k] != 0;
+        }
+
+        // Stop once every traversal still missing this vertex has been found
+        for (uint64_t e = incoming->offsets[v]; any && e < incoming->offsets[v + 1]; ++e) {
+            const uint64_t* frontier = state->visit + (size_t)incoming->neighbors[e] * words;
+            bool covered = true;
+            for (int k = 0; k < words; ++k) {
+                gathered[k] |= frontier[k];
+                covered = covered && (gathered[k] & pending[k]) == pending[k];
+            }
+            any = !covered;
+        }
+
+        bool reached = false;
+        for (int k = 0; k < words; ++k) {
+            uint64_t fresh = gathered[k] & pending[k];
+            atomic_store_explicit(&next[k], fresh, memory_order_relaxed);
+            seen[k] |= fresh;
+            msbfsRecord(state, found, (uint32_t)v, k, fresh);
+            reached = reached || fresh != 0;
+        }
+        if (reached) {
+            msbfsListPush(&state->lists[worker], (uint32_t)v);
+        }
+    }
+}
+
+// Helper for a top-down level over a slice of the frontier: push each vertex's frontier bits
+// to its out-neighbours that those traversals have not reached
+void msbfsPushSlice(long begin, long end, int worker, void* ctx) {
+    struct MSBFSState* state = (struct MSBFSState*)ctx;
+    const struct CSRGraph* csr = state->csr;
+    int words = state->words;
+
+    for (long i = begin; i < end; ++i) {
+        uint32_t u = state->frontier[i];
+        const uint64_t* visit = state->visit + (size_t)u * words;
+        for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+            uint32_t v = csr->neighbors[e];
+            const uint64_t* seen = state->seen + (size_t)v * words;
+            bool pushed = false;
+            for (int k = 0; k < words; ++k) {
+                uint64_t bits = visit[k] & ~seen[k];
+                if (bits) {
+                    atomic_fetch_or_explicit(&state->visitNext[(size_t)v * words + k], bits, memory_order_relaxed);
+                    pushed = true;
+                }
+            }
+            if (pushed && !atomic_exchange_explicit(&state->claimed[v], true, memory_order_relaxed)) {
+                msbfsListPush(&state->lists[worker], v);
+            }
+        }
+    }
+}
+
+// Helper to finish a top-down level over a slice of the vertices it listed: mark the pushed
+// bits as seen and record them
+void msbfsSettleSlice(long begin, long end, int worker, void* ctx) {
+    struct MSBFSState* state = (struct MSBFSState*)ctx;
+    int words = state->words;
+    uint64_t* found = state->found + (size_t)worker * state->count;
+
+    for (long i = begin; i < end; ++i) {
+        uint32_t v = state->frontier[i];
+        uint64_t* seen = state->seen + (size_t)v * words;
+        atomic_store_explicit(&state->claimed[v], false, memory_order_relaxed);
+        for (int k = 0; k < words; ++k) {
+            uint64_t fresh = atomic_load_explicit(&state->visitNext[(size_t)v * words + k], memory_order_relaxed);
+            seen[k] |= fresh;
+            msbfsRecord(state, found, v, k, fresh);
+        }
+    }
+}
+
+// Helper to gather the workers' lists into frontier
+void msbfsCollect(struct MSBFSState* state, int workers, uint32_t* frontier) {
+    state->frontierSize = 0;
+    for (int w = 0; w < workers; ++w) {
+        if (state->lists[w].count > 0) {
+            memcpy(frontier + state->frontierSize, state->lists[w].items, state->lists[w].count * sizeof(uint32_t));
+            state->frontierSize += state->lists[w].count;
+        }
+        state->lists[w].count = 0;
+    }
+}
+
+// Helper to run one batch of at most MSBFS_MAX_SOURCES sources
+void msbfsBatch(const struct CSRGraph* csr, const struct CSRGraph* incoming, const uint32_t* sources, int count,
+                int* distances, struct MSBFSStats* stats, int workers) {
+    struct MSBFSState state;
+    size_t cells = (size_t)incoming->vertices * ((count + 63) / 64);
+    uint32_t* spare = (uint32_t*)malloc(((size_t)incoming->vertices + 1) * sizeof(uint32_t));
+
+    state.csr = csr;
+    state.incoming = incoming;
+    state.words = (count + 63) / 64;
+    state.count = count;
+    state.vertices = incoming->vertices;
+    for (int k = 0; k < state.words; ++k) {
+        int bits = count - 64 * k;
+        state.full[k] = bits >= 64 ? ~0ull : (1ull << bits) - 1;
+    }
+    state.seen = (uint64_t*)calloc(cells, sizeof(uint64_t));
+    state.visit = (uint64_t*)calloc(cells, sizeof(uint64_t));
+    state.visitNext = (_Atomic uint64_t*)calloc(cells, sizeof(_Atomic uint64_t));
+    state.claimed = (_Atomic bool*)calloc(incoming->vertices, sizeof(_Atomic bool));
+    state.frontier = (uint32_t*)malloc(((size_t)incoming->vertices + 1) * sizeof(uint32_t));
+    state.frontierSize = 0;
+    state.lists = (struct MSBFSList*)calloc(workers, sizeof(struct MSBFSList));
+    state.found = (uint64_t*)malloc((size_t)workers * count * sizeof(uint64_t));
+    state.distances = distances;
+
+    if (distances) {
+        for (size_t i = 0; i < (size_t)count * incoming->vertices; ++i) {
+            distances[i] = -1;
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        size_t cell = (size_t)sources[i] * state.words + i / 64;
+        if (!atomic_exchange_explicit(&state.claimed[sources[i]], true, memory_order_relaxed)) {
+            state.frontier[state.frontierSize++] = sources[i];
+        }
+        state.seen[cell] |= 1ull << (i % 64);
+        state.visit[cell] |= 1ull << (i % 64);
+        stats[i].reached = 1;
+        stats[i].distanceSum = 0;
+        stats[i].eccentricity = 0;
+        if (distances) {
+            distances[(size_t)i * incoming->vertices + sources[i]] = 0;
+        }
+    }
+    for (uint32_t i = 0; i < state.frontierSize; ++i) {
+        atomic_store_explicit(&state.claimed[state.frontier[i]], false, memory_order_relaxed);
+    }
+
+    for (state.level = 1;; state.level++) {
+        uint32_t* previous = state.frontier;
+        uint32_t previousSize = state.frontierSize;
+        memset(state.found, 0, (size_t)workers * count * sizeof(uint64_t));
+
+        // Push while the frontier's out-edges are a small share of the graph, as in csrParallelBfs
+        uint64_t frontierEdges = 0;
+        for (uint32_t i = 0; i < previousSize; ++i) {
+            frontierEdges += csrDegree(csr, previous[i]);
+        }
+        if (frontierEdges * CSR_BFS_ALPHA < incoming->edges) {
+            parallel_for(0, previousSize, workers, msbfsPushSlice, &state);
+            msbfsCollect(&state, workers, spare);
+            state.frontier = spare;
+            parallel_for(0, state.frontierSize, workers, msbfsSettleSlice, &state);
+        } else {
+            parallel_for(0, incoming->vertices, workers, msbfsPullSlice, &state);
+            msbfsCollect(&state, workers, spare);
+            state.frontier = spare;
+        }
+        spare = previous;
+
+        bool active = false;
+        for (int i = 0; i < count; ++i) {
+            uint64_t reached = 0;
+            for (int w = 0; w < workers; ++w) {
+                reached += state.found[(size_t)w * count + i];
+            }
+            if (reached > 0) {
+                stats[i].reached += (uint32_t)reached;
+                stats[i].distanceSum += reached * state.level;
+                stats[i].eccentricity = state.level;
+                active = true;
+            }
+        }
+        if (!active) {
+            break;
+        }
+
+        // The old visit array becomes visitNext; clearing the old frontier leaves it all zero
+        uint64_t* swap = state.visit;
+        state.visit = (uint64_t*)state.visitNext;
+        state.visitNext = (_Atomic uint64_t*)swap;
+        for (uint32_t i = 0; i < previousSize; ++i) {
+            for (int k = 0; k < state.words; ++k) {
+                atomic_store_explicit(&state.visitNext[(size_t)previous[i] * state.words + k], 0, memory_order_relaxed);
+            }
+        }
+    }
+
+    free(state.seen);
+    free(state.visit);
+    free((void*)state.visitNext);
+    free((void*)state.claimed);
+    free(state.frontier);
+    free(spare);
+    for (int w = 0; w < workers; ++w) {
+        free(state.lists[w].items);
+    }
+    free(state.lists);
+    free(state.found);
+}
+
+// Function to run a BFS from each of count sources, sharing every edge scan across up to
+// MSBFS_MAX_SOURCES sources at a time. incoming is the transpose of csr (createCSRTranspose), or
+// NULL if csr is symmetric. Fills stats[i] for source i and, unless distances is NULL,
+// distances[i * V + v] with the distance from source i to v (-1 if unreached).
+void csrMultiSourceBfs(const struct CSRGraph* csr, const struct CSRGraph* incoming, const uint32_t* sources,
+                       int count, int* distances, struct MSBFSStats* stats) {
+    int workers = parallel_num_threads();
+
+    if (incoming == NULL) {
+        incoming = csr;
+    }
+    for (int first = 0; first < count; first += MSBFS_MAX_SOURCES) {
+        int batch = count - first < MSBFS_MAX_SOURCES ? count - first : MSBFS_MAX_SOURCES;
+        msbfsBatch(csr, incoming, sources + first, batch,
+                   distances ? distances + (size_t)first * csr->vertices : NULL,
+                   stats + first, workers);
+    }
+}
+
+// Function to run csrMultiSourceBfs on an adjacency-list graph
+void multiSourceBfs(struct Graph* graph, const int* sources, int count, int* distances, struct MSBFSStats* stats) {
+    struct CSRGraph* csr = createCSRFromGraph(graph);
+    struct CSRGraph* incoming = createCSRTranspose(csr);
+    csrMultiSourceBfs(csr, incoming, (const uint32_t*)sources, count, distances, stats);
+    freeCSRGraph(incoming);
+    freeCSRGraph(csr);
+}
+
+#endif
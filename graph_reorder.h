@@ -0,0 +1,332 @@
+#ifndef GRAPH_REORDER_H
+#define GRAPH_REORDER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "graph_csr.h"
+
+// Vertex reordering for locality. Every ordering fills perm (perm[oldId] = newId) and
+// inverse (inverse[newId] = oldId); csrPermute then relabels the graph. Results computed on
+// the relabelled graph map back to the original ids through inverse.
+
+enum VertexOrdering {
+    ORDER_DEGREE,  // Out-degree descending, hubs first
+    ORDER_BFS,     // BFS order, one component after another
+    ORDER_RCM      // Reverse Cuthill-McKee
+};
+
+// Locality of a labelling, over every stored edge (u, v)
+struct OrderingMetrics {
+    uint64_t bandwidth;  // Largest |u - v|
+    double averageGap;   // Mean |u - v|
+};
+
+// Helper to fill inverse from perm
+void orderingInverse(const uint32_t* perm, uint32_t vertices, uint32_t* inverse) {
+    for (uint32_t v = 0; v < vertices; ++v) {
+        inverse[perm[v]] = v;
+    }
+}
+
+// Function to order vertices by out-degree, highest first; ties keep their original order
+void csrDegreeOrder(const struct CSRGraph* csr, uint32_t* perm, uint32_t* inverse) {
+    uint64_t maxDegree = 0;
+    for (uint32_t v = 0; v < csr->vertices; ++v) {
+        uint64_t degree = csrDegree(csr, v);
+        maxDegree = degree > maxDegree ? degree : maxDegree;
+    }
+
+    // Counting sort on degree, buckets laid out from the highest degree down
+    uint64_t* start = (uint64_t*)calloc(maxDegree + 2, sizeof(uint64_t));
+    for (uint32_t v = 0; v < csr->vertices; ++v) {
+        start[maxDegree - csrDegree(csr, v) + 1]++;
+    }
+    for (uint64_t d = 1; d <= maxDegree + 1; ++d) {
+        start[d] += start[d - 1];
+    }
+    for (uint32_t v = 0; v < csr->vertices; ++v) {
+        perm[v] = (uint32_t)start[maxDegree - csrDegree(csr, v)]++;
+    }
+    free(start);
+    orderingInverse(perm, csr->vertices, inverse);
+}
+
+// Neighbour batch entry sorted by the Cuthill-McKee step
+struct OrderingEntry {
+    uint64_t degree;
+    uint32_t id;
+};
+
+// Helper for qsort on (degree, id)
+int orderingCompareEntries(const void* a, const void* b) {
+    const struct OrderingEntry* x = (const struct OrderingEntry*)a;
+    const struct OrderingEntry* y = (const struct OrderingEntry*)b;
+    if (x->degree != y->degree) {
+        return x->degree < y->degree ? -1 : 1;
+    }
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+// Helper to sort a batch of vertices by (degree, id)
+void orderingSortBatch(const struct CSRGraph* csr, uint32_t* batch, uint32_t count) {
+    if (count > CSR_SORT_INSERTION_MAX) {
+        // Hubs queue huge batches, where insertion sort would be quadratic
+        struct OrderingEntry* entries = (struct OrderingEntry*)malloc(count * sizeof(struct OrderingEntry));
+        for (uint32_t i = 0; i < count; ++i) {
+            entries[i].degree = csrDegree(csr, batch[i]);
+            entries[i].id = batch[i];
+        }
+        qsort(entries, count, sizeof(struct OrderingEntry), orderingCompareEntries);
+        for (uint32_t i = 0; i < count; ++i) {
+            batch[i] = entries[i].id;
+        }
+        free(entries);
+        return;
+    }
+    for (uint32_t i = 1; i < count; ++i) {
+        struct OrderingEntry entry = { csrDegree(csr, batch[i]), batch[i] };
+        uint32_t j = i;
+        for (; j > 0; --j) {
+            struct OrderingEntry previous = { csrDegree(csr, batch[j - 1]), batch[j - 1] };
+            if (orderingCompareEntries(&previous, &entry) <= 0) {
+                break;
+            }
+            batch[j] = batch[j - 1];
+        }
+        batch[j] = entry.id;
+    }
+}
+
+// Helper to BFS from root, numbering vertices from next; with byDegree each vertex's unvisited
+// neighbours are numbered in increasing (degree, id) order (Cuthill-McKee). Returns the next free number.
+uint32_t orderingBfs(const struct CSRGraph* csr, uint32_t root, bool byDegree, bool* visited,
+                     uint32_t* inverse, uint32_t next) {
+    uint32_t head = next;
+
+    visited[root] = true;
+    inverse[next++] = root;
+    while (head < next) {
+        uint32_t u = inverse[head++];
+        uint32_t first = next;
+        for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+            uint32_t v = csr->neighbors[e];
+            if (!visited[v]) {
+                visited[v] = true;
+                inverse[next++] = v;
+            }
+        }
+        if (byDegree) {
+            orderingSortBatch(csr, inverse + first, next - first);
+        }
+    }
+    return next;
+}
+
+// Helper to find a pseudo-peripheral vertex of root's component: repeatedly jump to a
+// lowest-degree vertex of the last BFS level while that makes the BFS deeper
+uint32_t orderingPeripheral(const struct CSRGraph* csr, uint32_t root, bool* visited, uint32_t* queue) {
+    uint32_t bestDepth = 0;
+
+    for (int round = 0; round < 4; ++round) {
+        uint32_t head = 0, tail = 0, depth = 0, levelStart = 0;
+        queue[tail++] = root;
+        visited[root] = true;
+        while (head < tail) {
+            uint32_t levelEnd = tail;
+            levelStart = head;
+            for (; head < levelEnd; ++head) {
+                uint32_t u = queue[head];
+                for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+                    if (!visited[csr->neighbors[e]]) {
+                        visited[csr->neighbors[e]] = true;
+                        queue[tail++] = csr->neighbors[e];
+                    }
+                }
+            }
+            if (tail > levelEnd) {
+                depth++;
+            }
+        }
+        for (uint32_t i = 0; i < tail; ++i) {
+            visited[queue[i]] = false;
+        }
+
+        uint32_t candidate = queue[levelStart];
+        for (uint32_t i = levelStart; i < tail; ++i) {
+            if (csrDegree(csr, queue[i]) < csrDegree(csr, candidate)) {
+                candidate = queue[i];
+            }
+        }
+        if (round > 0 && depth <= bestDepth) {
+            break;
+        }
+        bestDepth = depth;
+        root = candidate;
+    }
+    return root;
+}
+
+// Function to order vertices by BFS (byDegree false) or reverse Cuthill-McKee (byDegree true),
+// taking components in order of their smallest vertex id. RCM starts each component from a
+// pseudo-peripheral vertex. On a directed graph that BFS may miss the vertex that led to it,
+// which then starts a BFS of its own, so every vertex is numbered.
+void csrTraversalOrder(const struct CSRGraph* csr, bool byDegree, uint32_t* perm, uint32_t* inverse) {
+    bool* visited = (bool*)calloc(csr->vertices, sizeof(bool));
+    uint32_t* queue = byDegree ? (uint32_t*)malloc(csr->vertices * sizeof(uint32_t)) : NULL;
+    uint32_t next = 0;
+
+    for (uint32_t v = 0; v < csr->vertices; ++v) {
+        if (!visited[v]) {
+            uint32_t root = byDegree ? orderingPeripheral(csr, v, visited, queue) : v;
+            next = orderingBfs(csr, root, byDegree, visited, inverse, next);
+        }
+        if (!visited[v]) {
+            next = orderingBfs(csr, v, byDegree, visited, inverse, next);
+        }
+    }
+    if (byDegree) {
+        for (uint32_t i = 0, j = csr->vertices; i + 1 < j; ++i, --j) {
+            uint32_t tmp = inverse[i];
+            inverse[i] = inverse[j - 1];
+            inverse[j - 1] = tmp;
+        }
+    }
+    for (uint32_t i = 0; i < csr->vertices; ++i) {
+        perm[inverse[i]] = i;
+    }
+
+    free(visited);
+    free(queue);
+}
+
+// Function to compute perm and inverse for the requested ordering
+void csrComputeOrdering(const struct CSRGraph* csr, enum VertexOrdering ordering, uint32_t* perm, uint32_t* inverse) {
+    if (ordering == ORDER_DEGREE) {
+        csrDegreeOrder(csr, perm, inverse);
+    } else {
+        csrTraversalOrder(csr, ordering == ORDER_RCM, perm, inverse);
+    }
+}
+
+// Shared state of csrPermute and csrOrderingMetrics
+struct PermuteState {
+    const struct CSRGraph* csr;
+    struct CSRGraph* result;
+    const uint32_t* perm;
+    const uint32_t* inverse;
+    uint64_t* workerMax;
+    uint64_t* workerSum;
+};
+
+// Helper to copy the relabelled neighbour lists of a slice of new vertex ids
+void permuteCopySlice(long begin, long end, int worker, void* ctx) {
+    struct PermuteState* state = (struct PermuteState*)ctx;
+    const struct CSRGraph* csr = state->csr;
+    (void)worker;
+    for (long v = begin; v < end; ++v) {
+        uint32_t old = state->inverse[v];
+        uint32_t* out = state->result->neighbors + state->result->offsets[v];
+        for (uint64_t e = csr->offsets[old]; e < csr->offsets[old + 1]; ++e) {
+            *out++ = state->perm[csr->neighbors[e]];
+        }
+        if (csr->weights) {
+            memcpy(state->result->weights + state->result->offsets[v], csr->weights + csr->offsets[old],
+                   csrDegree(csr, old) * sizeof(int));
+        }
+    }
+}
+
+// Function to relabel a CSR graph so vertex v becomes perm[v]; neighbour lists come out sorted,
+// each edge keeping its weight
+struct CSRGraph* csrPermute(const struct CSRGraph* csr, const uint32_t* perm, const uint32_t* inverse) {
+    struct CSRGraph* result = createCSRGraph(csr->vertices, csr->edges);
+    struct PermuteState state = { csr, result, perm, inverse, NULL, NULL };
+    if (csr->weights) {
+        result->weights = (int*)malloc((csr->edges > 0 ? csr->edges : 1) * sizeof(int));
+    }
+    int workers = parallel_num_threads();
+
+    uint64_t running = 0;
+    for (uint32_t v = 0; v < csr->vertices; ++v) {
+        result->offsets[v] = running;
+        running += csrDegree(csr, inverse[v]);
+    }
+    result->offsets[csr->vertices] = running;
+
+    parallel_for(0, csr->vertices, workers, permuteCopySlice, &state);
+    parallel_for(0, csr->vertices, workers, csrSortSlice, result);
+    return result;
+}
+
+// Helper to measure the edge spans of a slice of vertices
+void orderingMetricsSlice(long begin, long end, int worker, void* ctx) {
+    struct PermuteState* state = (struct PermuteState*)ctx;
+    const struct CSRGraph* csr = state->csr;
+    uint64_t max = 0, sum = 0;
+    for (long u = begin; u < end; ++u) {
+        for (uint64_t e = csr->offsets[u]; e < csr->offsets[u + 1]; ++e) {
+            uint32_t v = csr->neighbors[e];
+            uint64_t gap = v > (uint32_t)u ? v - (uint64_t)u : (uint64_t)u - v;
+            max = gap > max ? gap : max;
+            sum += gap;
+        }
+    }
+    state->workerMax[worker] = max;
+    state->workerSum[worker] = sum;
+}
+
+// Function to measure the bandwidth and average neighbour id gap of a labelling
+struct OrderingMetrics csrOrderingMetrics(const struct CSRGraph* csr) {
+    int workers = parallel_num_threads();
+    struct PermuteState state = { csr, NULL, NULL, NULL, NULL, NULL };
+    struct OrderingMetrics metrics = { 0, 0 };
+    uint64_t sum = 0;
+
+    state.workerMax = (uint64_t*)calloc(workers, sizeof(uint64_t));
+    state.workerSum = (uint64_t*)calloc(workers, sizeof(uint64_t));
+    parallel_for(0, csr->vertices, workers, orderingMetricsSlice, &state);
+    for (int w = 0; w < workers; ++w) {
+        metrics.bandwidth = state.workerMax[w] > metrics.bandwidth ? state.workerMax[w] : metrics.bandwidth;
+        sum += state.workerSum[w];
+    }
+    metrics.averageGap = csr->edges > 0 ? (double)sum / csr->edges : 0;
+
+    free(state.workerMax);
+    free(state.workerSum);
+    return metrics;
+}
+
+// Function to reorder a CSR graph in one call: computes the ordering, fills perm and inverse,
+// and returns the relabelled graph. before and after receive the metrics unless NULL.
+struct CSRGraph* csrReorder(const struct CSRGraph* csr, enum VertexOrdering ordering, uint32_t* perm,
+                            uint32_t* inverse, struct OrderingMetrics* before, struct OrderingMetrics* after) {
+    csrComputeOrdering(csr, ordering, perm, inverse);
+    struct CSRGraph* result = csrPermute(csr, perm, inverse);
+    if (before != NULL) {
+        *before = csrOrderingMetrics(csr);
+    }
+    if (after != NULL) {
+        *after = csrOrderingMetrics(result);
+    }
+    return result;
+}
+
+// Function to build a reordered CSR copy of an adjacency-list graph; see csrReorder
+struct CSRGraph* reorderGraph(struct Graph* graph, enum VertexOrdering ordering, int* perm, int* inverse,
+                              struct OrderingMetrics* before, struct OrderingMetrics* after) {
+    struct CSRGraph* csr = createCSRFromGraph(graph);
+    struct CSRGraph* result = csrReorder(csr, ordering, (uint32_t*)perm, (uint32_t*)inverse, before, after);
+    freeCSRGraph(csr);
+    return result;
+}
+
+// Function to print the locality metrics of a labelling before and after reordering
+void printOrderingMetrics(const struct OrderingMetrics* before, const struct OrderingMetrics* after) {
+    printf("Bandwidth: %llu -> %llu\n", (unsigned long long)before->bandwidth, (unsigned long long)after->bandwidth);
+    printf("Average neighbour gap: %.1f -> %.1f\n", before->averageGap, after->averageGap);
+}
+
+#endif
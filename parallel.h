@@ -0,0 +1,129 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// Minimal fork-join helpers on top of pthreads
+
+// Function to get the number of worker threads to use (PARALLEL_THREADS overrides the core count)
+int parallel_num_threads(void) {
+    const char* env = getenv("PARALLEL_THREADS");
+    if (env != NULL && atoi(env) > 0) {
+        return atoi(env);
+    }
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+}
+
+// Number of extra threads parallel_invoke may still start; -1 until first use
+static atomic_int parallel_spare_threads = -1;
+
+// Helper to claim one extra thread from the budget
+int parallel_claim_thread(void) {
+    int spare = atomic_load(&parallel_spare_threads);
+    if (spare < 0) {
+        int expected = -1;
+        atomic_compare_exchange_strong(&parallel_spare_threads, &expected, parallel_num_threads() - 1);
+        spare = atomic_load(&parallel_spare_threads);
+    }
+    while (spare > 0) {
+        if (atomic_compare_exchange_weak(&parallel_spare_threads, &spare, spare - 1)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+struct ParallelTask {
+    void (*fn)(void*);
+    void* arg;
+};
+
+// Helper to run a task on a pthread
+void* parallel_task_main(void* task) {
+    struct ParallelTask* t = (struct ParallelTask*)task;
+    t->fn(t->arg);
+    return NULL;
+}
+
+// Function to run a(a_arg) and b(b_arg), in parallel when a spare thread is available
+void parallel_invoke(void (*a)(void*), void* a_arg, void (*b)(void*), void* b_arg) {
+    struct ParallelTask task = { a, a_arg };
+    pthread_t thread;
+
+    if (parallel_claim_thread()) {
+        if (pthread_create(&thread, NULL, parallel_task_main, &task) == 0) {
+            b(b_arg);
+            pthread_join(thread, NULL);
+            atomic_fetch_add(&parallel_spare_threads, 1);
+            return;
+        }
+        atomic_fetch_add(&parallel_spare_threads, 1);
+    }
+    a(a_arg);
+    b(b_arg);
+}
+
+// Range of loop iterations handed to one worker by parallel_for
+struct ParallelRange {
+    long begin, end;
+    int worker;
+    void (*body)(long begin, long end, int worker, void* ctx);
+    void* ctx;
+};
+
+// Helper to run one slice of a parallel_for on a pthread
+void* parallel_range_main(void* range) {
+    struct ParallelRange* r = (struct ParallelRange*)range;
+    r->body(r->begin, r->end, r->worker, r->ctx);
+    return NULL;
+}
+
+// Function to split [begin, end) into one contiguous slice per worker and run body on each.
+// body receives its slice and a worker index in [0, workers); returns the number of workers used.
+int parallel_for(long begin, long end, int workers, void (*body)(long begin, long end, int worker, void* ctx), void* ctx) {
+    long count = end - begin;
+    if (workers > count) {
+        workers = count > 0 ? (int)count : 1;
+    }
+    if (workers <= 1) {
+        body(begin, end, 0, ctx);
+        return 1;
+    }
+
+    struct ParallelRange* ranges = (struct ParallelRange*)malloc(workers * sizeof(struct ParallelRange));
+    pthread_t* threads = (pthread_t*)malloc(workers * sizeof(pthread_t));
+    bool* started = (bool*)calloc(workers, sizeof(bool));
+
+    for (int w = 0; w < workers; ++w) {
+        ranges[w].begin = begin + count * w / workers;
+        ranges[w].end = begin + count * (w + 1) / workers;
+        ranges[w].worker = w;
+        ranges[w].body = body;
+        ranges[w].ctx = ctx;
+    }
+    // Worker 0 runs on the calling thread; any slice that fails to start runs there too
+    for (int w = 1; w < workers; ++w) {
+        started[w] = pthread_create(&threads[w], NULL, parallel_range_main, &ranges[w]) == 0;
+    }
+    body(ranges[0].begin, ranges[0].end, 0, ctx);
+    for (int w = 1; w < workers; ++w) {
+        if (started[w]) {
+            pthread_join(threads[w], NULL);
+        } else {
+            body(ranges[w].begin, ranges[w].end, w, ctx);
+        }
+    }
+
+    free(started);
+    free(threads);
+    free(ranges);
+    return workers;
+}
+
+#endif